@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// fixed-size set of bits packed into 64-bit words
+class Bitset {
+private:
+    vector<uint64_t> words;
+
+public:
+    // n cleared bits
+    void Reset(size_t n) { words.assign((n + 63) / 64, 0); }
+
+    bool Test(size_t i) const { return (words[i / 64] >> (i % 64)) & 1; }
+    void Flip(size_t i) { words[i / 64] ^= uint64_t(1) << (i % 64); }
+};
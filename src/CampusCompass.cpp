@@ -1,22 +1,817 @@
 #include "CampusCompass.h"
+#include "CommandLexer.h"
+#include "CsvScanner.h"
+#include "MappedFile.h"
+#include "ShortestPath.h"
+#include "Snapshot.h"
+#include "ThreadPool.h"
 
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <queue>
 #include <string>
 
 using namespace std;
 
-CampusCompass::CampusCompass() {
-    // initialize your object
+namespace {
+
+// edges.csv is only split across threads once each chunk would be at least this big
+const size_t kMinChunkBytes = 1 << 20;
+
+// bound on cached shortest path trees (each is three ints per location)
+const size_t kMaxCachedTrees = 256;
+
+// PathEngine::Automatic only uses the all-pairs matrix up to this many
+// locations, where Floyd-Warshall costs about as much as a few dozen trees,
+// and only if it takes at most a quarter of the free memory (or this much
+// when the platform cannot tell). Past that, the n^3 build and the rebuild
+// after every toggle cost far more than the trees they replace.
+const int kMaxMatrixLocations = 256;
+const size_t kMatrixBytesWhenUnknown = 64 << 20;
+
+// stable insertion sort for the handful (at most kMaxClasses) of entries a
+// student has; std::sort's unrolled paths trip -Warray-bounds on fixed arrays
+template <typename T, typename Less>
+void SortFew(T *first, T *last, Less less) {
+    for (T *it = first + 1; it < last; ++it) {
+        T value = *it;
+        T *hole = it;
+        for (; hole != first && less(value, *(hole - 1)); --hole) {
+            *hole = *(hole - 1);
+        }
+        *hole = value;
+    }
+}
+
+// splits text into at most parts pieces that each end just after a newline
+vector<string_view> SplitAtNewlines(string_view text, size_t parts) {
+    vector<string_view> chunks;
+    size_t target = text.size() / parts + 1;
+    while (!text.empty()) {
+        size_t end = text.size() <= target ? string_view::npos : text.find('\n', target);
+        end = end == string_view::npos ? text.size() : end + 1;
+        chunks.push_back(text.substr(0, end));
+        text.remove_prefix(end);
+    }
+    return chunks;
+}
+
+// parses the data rows of one chunk of edges.csv into edges
+bool ParseEdgeRows(string_view text, vector<RawEdge> &edges) {
+    string_view fields[5];
+    int count;
+    CsvScanner rows(text);
+    while ((count = rows.NextRow(fields, 5)) != 0) {
+        RawEdge edge;
+        if (count != 5 || !ParseNumber(fields[0], edge.from_id) ||
+            !ParseNumber(fields[1], edge.to_id) || !ParseNumber(fields[4], edge.time)) {
+            return false;
+        }
+        edge.from_name = fields[2];
+        edge.to_name = fields[3];
+        edges.push_back(edge);
+    }
+    return true;
+}
+
+// Parses the rows of edges.csv (header already removed). Large files are cut
+// into newline-aligned chunks that are parsed on a thread pool, each into its
+// own buffer; CampusGraph::Build merges the buffers.
+bool ParseEdges(string_view text, vector<vector<RawEdge>> &chunks) {
+    size_t chunk_count = text.size() / kMinChunkBytes;
+    chunk_count = min(chunk_count, (size_t)ThreadPool::DefaultThreadCount() * 4);
+    if (chunk_count <= 1) {
+        chunks.assign(1, {});
+        return ParseEdgeRows(text, chunks[0]);
+    }
+
+    vector<string_view> pieces = SplitAtNewlines(text, chunk_count);
+    chunks.assign(pieces.size(), {});
+    vector<char> ok(pieces.size(), false); // not vector<bool>: each task writes its own slot
+    ThreadPool pool(min((int)pieces.size(), ThreadPool::DefaultThreadCount()));
+    for (size_t i = 0; i < pieces.size(); i++) {
+        pool.Submit([&, i] { ok[i] = ParseEdgeRows(pieces[i], chunks[i]); });
+    }
+    pool.Wait();
+    return all_of(ok.begin(), ok.end(), [](char chunk_ok) { return chunk_ok; });
+}
+
+} // namespace
+
+CampusCompass::CampusCompass()
+    : graph(make_shared<CampusGraph>()), stdout_sink(new FdSink(1)), output(stdout_sink.get()), landmark_count(0) {
+}
+
+CampusCompass::CampusCompass(OutputSink &sink, int landmark_count)
+    : graph(make_shared<CampusGraph>()), output(&sink), landmark_count(landmark_count) {
+}
+
+void CampusCompass::GraphChanged() {
+    closed_edges.Reset(graph->EdgeCount());
+    path_trees.clear();
+    hierarchy = ContractionHierarchy();
+    hierarchy_current = false;
+    landmarks.Build(*graph, landmark_count);
+    matrix.Clear();
+    matrix_current = false;
+    size_t bytes = DistanceMatrix::BytesNeeded(*graph);
+    size_t available = DistanceMatrix::AvailableMemory();
+    matrix_fits = graph->LocationCount() <= kMaxMatrixLocations &&
+                  (available == 0 ? bytes <= kMatrixBytesWhenUnknown : bytes <= available / 4);
+
+    // catalog indexes may have moved, so enrol everyone again
+    rosters.assign(classes.size(), vector<int>());
+    for (int slot = 0; slot < students.SlotCount(); slot++) {
+        if (students.IsUsed(slot)) {
+            for (int i = 0; i < (int)students.At(slot).classes.size(); i++) {
+                Enroll(slot, i);
+            }
+        }
+    }
+}
+
+ThreadPool &CampusCompass::Workers() const {
+    if (!workers) {
+        workers.reset(new ThreadPool());
+    }
+    return *workers;
+}
+
+const DistanceMatrix *CampusCompass::CurrentMatrix() const {
+    if (ActiveEngine() != PathEngine::Matrix) {
+        return nullptr;
+    }
+    if (!matrix_current) {
+        // a rebuild after closures is on the query path, so spread it over
+        // the cores; the first build is Floyd-Warshall
+        matrix_current = matrix.Build(*graph, closed_edges, matrix.Empty() ? nullptr : &Workers());
+    }
+    return matrix_current ? &matrix : nullptr;
+}
+
+template <typename NextLine>
+bool CampusCompass::RunBatch(NextLine next_line, OutputSink &sink) {
+    // first line: how many commands follow
+    string_view header;
+    if (!next_line(header)) {
+        return false;
+    }
+    while (!header.empty() && (header.front() == ' ' || header.front() == '\t')) {
+        header.remove_prefix(1);
+    }
+    while (!header.empty() && (header.back() == ' ' || header.back() == '\t' || header.back() == '\r')) {
+        header.remove_suffix(1);
+    }
+    int no_of_lines;
+    if (!ParseNumber(header, no_of_lines)) {
+        return false;
+    }
+
+    OutputSink *previous = output;
+    output = &sink;
+    string_view line;
+    for (int i = 0; i < no_of_lines && next_line(line); i++) {
+        Execute(line);
+    }
+    output = previous;
+    return true;
+}
+
+bool CampusCompass::ProcessBatch(string_view input, OutputSink &sink) {
+    return RunBatch(
+        [&input](string_view &line) {
+            if (input.empty()) {
+                return false;
+            }
+            size_t line_end = input.find('\n');
+            line = input.substr(0, line_end);
+            input.remove_prefix(line_end == string_view::npos ? input.size() : line_end + 1);
+            return true;
+        },
+        sink);
+}
+
+bool CampusCompass::ProcessStream(LineReader &lines, OutputSink &sink) {
+    return RunBatch(
+        [&lines, &sink](string_view &line) {
+            if (!lines.HasLine()) {
+                sink.Flush(); // about to wait for input, so let the results so far out
+            }
+            return lines.Next(line);
+        },
+        sink);
 }
 
 bool CampusCompass::ParseCSV(const string &edges_filepath, const string &classes_filepath) {
-    // return boolean based on whether parsing was successful or not
+    MappedFile edges_file, classes_file;
+    if (!edges_file.Open(edges_filepath) || !classes_file.Open(classes_filepath)) {
+        return false;
+    }
+
+    string_view edge_text = edges_file.View();
+    size_t header_end = edge_text.find('\n');
+    edge_text.remove_prefix(header_end == string_view::npos ? edge_text.size() : header_end + 1);
+    vector<vector<RawEdge>> edges;
+    if (!ParseEdges(edge_text, edges)) {
+        return false;
+    }
+
+    string_view fields[4];
+    int count;
+    vector<ClassInfo> parsed_classes;
+    CsvScanner class_rows(classes_file.View());
+    class_rows.NextRow(fields, 4); // header
+    while ((count = class_rows.NextRow(fields, 4)) != 0) {
+        ClassInfo info;
+        int location_id, start, end;
+        if (count != 4 || (info.key = EncodeClassCode(fields[0])) == 0 || !ParseNumber(fields[1], location_id) ||
+            !ParseClock(fields[2], start) || !ParseClock(fields[3], end)) {
+            return false;
+        }
+        info.location_id = location_id;
+        info.start = start;
+        info.end = end;
+        parsed_classes.push_back(info);
+    }
+
+    auto built = make_shared<CampusGraph>();
+    built->Build(edges);
+    graph = built;
+    classes.Build(move(parsed_classes));
+    GraphChanged();
+    return true;
+}
+
+bool CampusCompass::SaveSnapshot(const string &snapshot_filepath) const {
+    SnapshotWriter writer;
+    graph->Save(writer);
+    classes.Save(writer);
+    return writer.WriteTo(snapshot_filepath);
+}
+
+bool CampusCompass::LoadSnapshot(const string &snapshot_filepath, bool verify) {
+    SnapshotReader reader;
+    auto loaded_graph = make_shared<CampusGraph>();
+    ClassCatalog loaded_classes;
+    if (!reader.Open(snapshot_filepath, verify) || !loaded_graph->Load(reader) || !loaded_classes.Load(reader)) {
+        return false;
+    }
+    graph = loaded_graph;
+    classes = move(loaded_classes);
+    GraphChanged();
     return true;
 }
 
 bool CampusCompass::ParseCommand(const string &command) {
-    // do whatever regex you need to parse validity
-    // hint: return a boolean for validation when testing. For example:
-    bool is_valid = true; // replace with your actual validity checking
+    return Execute(command);
+}
+
+bool CampusCompass::Execute(string_view command) {
+    OutputSink &out = *output;
+    Command parsed;
+    bool is_valid = false;
+    bool printed = false;
+    if (LexCommand(command, parsed)) {
+        switch (parsed.verb) {
+        case CommandVerb::Insert:
+            is_valid = Insert(parsed.name, parsed.ufid, parsed.location_1, parsed.classes, parsed.class_count);
+            break;
+        case CommandVerb::Remove:
+            is_valid = Remove(parsed.ufid);
+            break;
+        case CommandVerb::DropClass:
+            is_valid = DropClass(parsed.ufid, parsed.classes[0]);
+            break;
+        case CommandVerb::ReplaceClass:
+            is_valid = ReplaceClass(parsed.ufid, parsed.classes[0], parsed.classes[1]);
+            break;
+        case CommandVerb::RemoveClass: {
+            int removed = RemoveClass(parsed.classes[0]);
+            if (removed >= 0) {
+                out << removed << '\n';
+                is_valid = printed = true;
+            }
+            break;
+        }
+        case CommandVerb::ToggleEdgesClosure: {
+            toggle_pairs.clear();
+            int x, y;
+            while (NextLocationPair(parsed.pairs, x, y)) {
+                toggle_pairs.emplace_back(x, y);
+            }
+            is_valid = ToggleEdgesClosure(toggle_pairs);
+            break;
+        }
+        case CommandVerb::CheckEdgeStatus:
+            out << CheckEdgeStatus(parsed.location_1, parsed.location_2) << '\n';
+            is_valid = printed = true;
+            break;
+        case CommandVerb::IsConnected:
+            is_valid = IsConnected(parsed.location_1, parsed.location_2);
+            break;
+        case CommandVerb::PrintShortestEdges:
+            is_valid = printed = PrintShortestEdges(parsed.ufid);
+            break;
+        case CommandVerb::PrintStudentZone:
+            is_valid = printed = PrintStudentZone(parsed.ufid);
+            break;
+        case CommandVerb::VerifySchedule:
+            is_valid = printed = VerifySchedule(parsed.ufid);
+            break;
+        }
+    }
 
+    if (!printed) {
+        out << (is_valid ? "successful" : "unsuccessful") << '\n';
+    }
     return is_valid;
 }
+
+bool CampusCompass::Insert(string_view name, int ufid, int residence_id, const vector<string_view> &class_codes) {
+    if (class_codes.empty() || class_codes.size() > kMaxClasses) {
+        return false;
+    }
+    ClassKey keys[kMaxClasses];
+    for (size_t i = 0; i < class_codes.size(); i++) {
+        keys[i] = EncodeClassCode(class_codes[i]);
+    }
+    return Insert(name, ufid, residence_id, keys, (int)class_codes.size());
+}
+
+bool CampusCompass::Insert(string_view name, int ufid, int residence_id, const ClassKey *class_keys, int class_count) {
+    if (students.Find(ufid) >= 0 || class_count < 1 || class_count > kMaxClasses) {
+        return false;
+    }
+    InlineVector<ClassKey, kMaxClasses> keys;
+    for (int i = 0; i < class_count; i++) {
+        keys.push_back(class_keys[i]);
+    }
+    for (ClassKey key : keys) {
+        if (!classes.Contains(key)) {
+            return false;
+        }
+    }
+    SortFew(keys.begin(), keys.end(), less<ClassKey>());
+    if (adjacent_find(keys.begin(), keys.end()) != keys.end()) {
+        return false;
+    }
+    int slot = students.Insert(ufid, residence_id, name);
+    Student &student = students.At(slot);
+    student.classes = keys;
+    students.ClassesChanged(slot);
+    for (int i = 0; i < class_count; i++) {
+        student.roster_positions.push_back(-1);
+        Enroll(slot, i);
+    }
+    return true;
+}
+
+bool CampusCompass::Remove(int ufid) {
+    int slot = students.Find(ufid);
+    if (slot < 0) {
+        return false;
+    }
+    for (int i = 0; i < (int)students.At(slot).classes.size(); i++) {
+        Unenroll(slot, i);
+    }
+    return students.Erase(ufid);
+}
+
+void CampusCompass::Enroll(int slot, int i) {
+    Student &student = students.At(slot);
+    int index = classes.Find(student.classes[i]);
+    if (index < 0) {
+        student.roster_positions[i] = -1;
+        return;
+    }
+    student.roster_positions[i] = (int)rosters[index].size();
+    rosters[index].push_back(slot);
+}
+
+void CampusCompass::Unenroll(int slot, int i) {
+    Student &student = students.At(slot);
+    int position = student.roster_positions[i];
+    if (position < 0) {
+        return;
+    }
+    ClassKey key = student.classes[i];
+    vector<int> &roster = rosters[classes.Find(key)];
+    int moved = roster.back();
+    roster[position] = moved;
+    roster.pop_back();
+    if (moved != slot) {
+        Student &other = students.At(moved);
+        auto at = lower_bound(other.classes.begin(), other.classes.end(), key);
+        other.roster_positions[at - other.classes.begin()] = position;
+    }
+    student.roster_positions[i] = -1;
+}
+
+void CampusCompass::RemoveIfEmpty(int ufid) {
+    const Student *student = students.Get(ufid);
+    if (student && student->classes.empty()) {
+        students.Erase(ufid);
+    }
+}
+
+bool CampusCompass::DropClass(int ufid, string_view class_code) {
+    return DropClass(ufid, EncodeClassCode(class_code));
+}
+
+bool CampusCompass::DropClass(int ufid, ClassKey key) {
+    int slot = students.Find(ufid);
+    if (slot < 0 || !classes.Contains(key)) {
+        return false;
+    }
+    Student &student = students.At(slot);
+    auto pos = find(student.classes.begin(), student.classes.end(), key);
+    if (pos == student.classes.end()) {
+        return false;
+    }
+    int i = (int)(pos - student.classes.begin());
+    Unenroll(slot, i);
+    student.classes.erase(pos);
+    student.roster_positions.erase(student.roster_positions.begin() + i);
+    students.ClassesChanged(slot);
+    RemoveIfEmpty(ufid);
+    return true;
+}
+
+bool CampusCompass::ReplaceClass(int ufid, string_view old_code, string_view new_code) {
+    return ReplaceClass(ufid, EncodeClassCode(old_code), EncodeClassCode(new_code));
+}
+
+bool CampusCompass::ReplaceClass(int ufid, ClassKey old_key, ClassKey new_key) {
+    int slot = students.Find(ufid);
+    if (slot < 0 || !classes.Contains(new_key)) {
+        return false;
+    }
+    Student &student = students.At(slot);
+    InlineVector<ClassKey, kMaxClasses> &enrolled = student.classes;
+    InlineVector<int32_t, kMaxClasses> &positions = student.roster_positions;
+    auto pos = find(enrolled.begin(), enrolled.end(), old_key);
+    if (pos == enrolled.end() || find(enrolled.begin(), enrolled.end(), new_key) != enrolled.end()) {
+        return false;
+    }
+    int i = (int)(pos - enrolled.begin());
+    Unenroll(slot, i);
+    enrolled.erase(pos);
+    positions.erase(positions.begin() + i);
+    int j = (int)(lower_bound(enrolled.begin(), enrolled.end(), new_key) - enrolled.begin());
+    enrolled.insert(enrolled.begin() + j, new_key);
+    positions.insert(positions.begin() + j, -1);
+    Enroll(slot, j);
+    students.ClassesChanged(slot);
+    return true;
+}
+
+int CampusCompass::RemoveClass(string_view class_code) {
+    return RemoveClass(EncodeClassCode(class_code));
+}
+
+int CampusCompass::RemoveClass(ClassKey key) {
+    int index = classes.Find(key);
+    if (index < 0) {
+        return -1;
+    }
+    // the whole roster goes, so nobody's position has to be patched
+    vector<int> roster = move(rosters[index]);
+    rosters[index].clear();
+    for (int slot : roster) {
+        Student &student = students.At(slot);
+        int i = (int)(lower_bound(student.classes.begin(), student.classes.end(), key) - student.classes.begin());
+        student.classes.erase(student.classes.begin() + i);
+        student.roster_positions.erase(student.roster_positions.begin() + i);
+        if (student.classes.empty()) {
+            students.Erase(student.ufid);
+        }
+    }
+    return (int)roster.size();
+}
+
+bool CampusCompass::ToggleEdgesClosure(const vector<pair<int, int>> &edges) {
+    vector<int> edge_ids;
+    for (const auto &[x, y] : edges) {
+        int edge = graph->FindEdge(x, y);
+        if (edge < 0) {
+            return false;
+        }
+        edge_ids.push_back(edge);
+    }
+
+    // an edge listed an even number of times ends up where it started
+    sort(edge_ids.begin(), edge_ids.end());
+    vector<int> closed_now, opened_now; // both sorted
+    for (size_t i = 0, j = 0; i < edge_ids.size(); i = j) {
+        while (j < edge_ids.size() && edge_ids[j] == edge_ids[i]) {
+            j++;
+        }
+        if ((j - i) % 2 == 0) {
+            continue;
+        }
+        (IsOpen(edge_ids[i]) ? closed_now : opened_now).push_back(edge_ids[i]);
+        closed_edges.Flip(edge_ids[i]);
+    }
+
+    if (!closed_now.empty() || !opened_now.empty()) {
+        hierarchy_current = false;
+        matrix_current = false;
+    }
+
+    // repair the cached trees: closures first, as if nothing had reopened yet
+    auto open_before_reopening = [&](int edge) {
+        return IsOpen(edge) && !binary_search(opened_now.begin(), opened_now.end(), edge);
+    };
+    auto is_open = [this](int edge) { return IsOpen(edge); };
+    auto repair = [&](ShortestPathTree &tree) {
+        if (!closed_now.empty()) {
+            RepairAfterClosures(*graph, tree, closed_now, open_before_reopening);
+        }
+        if (!opened_now.empty()) {
+            RepairAfterOpenings(*graph, tree, opened_now, is_open);
+        }
+    };
+    if (path_trees.size() == 1) {
+        repair(path_trees.begin()->second);
+    } else if (path_trees.size() > 1) {
+        // trees are independent and everything they read is fixed until Wait()
+        ThreadPool &pool = Workers();
+        for (auto &[source, tree] : path_trees) {
+            pool.Submit([&repair, &tree = tree] { repair(tree); });
+        }
+        pool.Wait();
+    }
+    return true;
+}
+
+string CampusCompass::CheckEdgeStatus(int location_x, int location_y) const {
+    int edge = graph->FindEdge(location_x, location_y);
+    if (edge < 0) {
+        return "DNE";
+    }
+    return IsOpen(edge) ? "open" : "closed";
+}
+
+bool CampusCompass::IsConnected(int location_1, int location_2) const {
+    int source = graph->DenseIndex(location_1);
+    int target = graph->DenseIndex(location_2);
+    if (source < 0 || target < 0) {
+        return false;
+    }
+    vector<bool> seen(graph->LocationCount(), false);
+    queue<int> frontier;
+    frontier.push(source);
+    seen[source] = true;
+    while (!frontier.empty()) {
+        int u = frontier.front();
+        frontier.pop();
+        if (u == target) {
+            return true;
+        }
+        for (int arc = graph->ArcBegin(u); arc < graph->ArcEnd(u); arc++) {
+            int v = graph->Neighbor(arc);
+            if (!seen[v] && IsOpen(graph->ArcEdge(arc))) {
+                seen[v] = true;
+                frontier.push(v);
+            }
+        }
+    }
+    return false;
+}
+
+const ShortestPathTree &CampusCompass::PathTree(int source) const {
+    auto cached = path_trees.find(source);
+    if (cached != path_trees.end()) {
+        return cached->second;
+    }
+    if (path_trees.size() >= kMaxCachedTrees) {
+        path_trees.clear();
+    }
+    ShortestPathTree &tree = path_trees[source];
+    auto is_open = [this](int edge) { return IsOpen(edge); };
+    if (graph->MaxTime() <= kMaxBucketWeight) {
+        Dijkstra<BucketQueue>(*graph, source, -1, is_open, tree);
+    } else {
+        Dijkstra<BinaryHeapQueue>(*graph, source, -1, is_open, tree);
+    }
+    return tree;
+}
+
+void CampusCompass::BuildHierarchy() {
+    hierarchy.Build(*graph, closed_edges);
+    hierarchy_current = true;
+}
+
+int CampusCompass::TravelTime(int from_id, int to_id) const {
+    int source = graph->DenseIndex(from_id);
+    int target = graph->DenseIndex(to_id);
+    if (source < 0 || target < 0) {
+        return -1;
+    }
+    if (const DistanceMatrix *all_pairs = CurrentMatrix()) {
+        return all_pairs->At(source, target);
+    }
+    if (engine == PathEngine::Hierarchy && hierarchy_current) {
+        return hierarchy.Query(source, target);
+    }
+    if (ActiveEngine() == PathEngine::SourceTree) {
+        return PathTree(source).dist[target];
+    }
+    int settled, time;
+    if (engine == PathEngine::Landmarks) {
+        time = landmarks.Query(*graph, closed_edges, source, target, &settled);
+    } else { // Bidirectional, or a hierarchy built with other closures
+        auto is_open = [this](int edge) { return IsOpen(edge); };
+        if (graph->MaxTime() <= kMaxBucketWeight) {
+            time = BidirectionalDijkstra<BucketQueue>(*graph, source, target, is_open, &settled);
+        } else {
+            time = BidirectionalDijkstra<BinaryHeapQueue>(*graph, source, target, is_open, &settled);
+        }
+    }
+    statistics.queries++;
+    statistics.settled += settled;
+    return time;
+}
+
+bool CampusCompass::PrintShortestEdges(int ufid) {
+    OutputSink &out = *output;
+    const Student *found = students.Get(ufid);
+    if (!found) {
+        return false;
+    }
+    const Student &student = *found;
+    int source = graph->DenseIndex(student.residence_id);
+    const DistanceMatrix *all_pairs = CurrentMatrix();
+    const vector<int> *dist = (source < 0 || all_pairs) ? nullptr : &PathTree(source).dist;
+    out << "Name: " << students.Name(student) << '\n';
+    for (ClassKey key : student.classes) {
+        // a class dropped from the catalog has nowhere to go to
+        const ClassInfo *info = classes.Get(key);
+        int target = info ? graph->DenseIndex(info->location_id) : -1;
+        int time = -1;
+        if (source >= 0 && target >= 0) {
+            time = all_pairs ? all_pairs->At(source, target) : (*dist)[target];
+        }
+        out << ClassCodeText(key).data() << " | Total Time: " << time << '\n';
+    }
+    return true;
+}
+
+int CampusCompass::StudentZoneCost(int ufid) const {
+    const Student *found = students.Get(ufid);
+    if (!found) {
+        return -1;
+    }
+    const Student &student = *found;
+    int source = graph->DenseIndex(student.residence_id);
+    if (source < 0) {
+        return 0;
+    }
+
+    // the zone is every location on a shortest path from the residence to a class
+    const ShortestPathTree &tree = PathTree(source);
+    const vector<int> &dist = tree.dist;
+    const vector<int> &parents = tree.parents;
+    vector<bool> in_zone(graph->LocationCount(), false);
+    in_zone[source] = true;
+    for (ClassKey key : student.classes) {
+        const ClassInfo *info = classes.Get(key);
+        int target = info ? graph->DenseIndex(info->location_id) : -1;
+        if (target < 0 || dist[target] < 0) {
+            continue;
+        }
+        for (int u = target; u != -1 && !in_zone[u]; u = parents[u]) {
+            in_zone[u] = true;
+        }
+    }
+
+    // Prim's MST over the open edges of the subgraph induced by the zone
+    int cost = 0;
+    vector<bool> done(graph->LocationCount(), false);
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> heap;
+    heap.emplace(0, source);
+    while (!heap.empty()) {
+        auto [weight, u] = heap.top();
+        heap.pop();
+        if (done[u]) {
+            continue;
+        }
+        done[u] = true;
+        cost += weight;
+        for (int arc = graph->ArcBegin(u); arc < graph->ArcEnd(u); arc++) {
+            int v = graph->Neighbor(arc);
+            if (in_zone[v] && !done[v] && IsOpen(graph->ArcEdge(arc))) {
+                heap.emplace(graph->Time(arc), v);
+            }
+        }
+    }
+    return cost;
+}
+
+bool CampusCompass::PrintStudentZone(int ufid) {
+    OutputSink &out = *output;
+    int cost = StudentZoneCost(ufid);
+    if (cost < 0) {
+        return false;
+    }
+    out << "Student Zone Cost For " << students.Name(*students.Get(ufid)) << ": " << cost << '\n';
+    return true;
+}
+
+bool CampusCompass::VerifySchedule(int ufid) {
+    OutputSink &out = *output;
+    const Student *found = students.Get(ufid);
+    if (!found || found->classes.size() < 2) {
+        return false;
+    }
+    const Student &student = *found;
+    vector<const ClassInfo *> schedule;
+    for (ClassKey key : student.classes) {
+        // classes no longer in the catalog have no time slot to check
+        if (const ClassInfo *info = classes.Get(key)) {
+            schedule.push_back(info);
+        }
+    }
+    stable_sort(schedule.begin(), schedule.end(),
+                [](const ClassInfo *lhs, const ClassInfo *rhs) { return lhs->start < rhs->start; });
+
+    out << "Schedule Check for " << students.Name(student) << ":" << '\n';
+    for (size_t i = 0; i + 1 < schedule.size(); i++) {
+        const ClassInfo &from = *schedule[i];
+        const ClassInfo &to = *schedule[i + 1];
+        int time = TravelTime(from.location_id, to.location_id);
+        bool can_make_it = time >= 0 && time <= to.start - from.end;
+        out << ClassCodeText(from.key).data() << " - " << ClassCodeText(to.key).data() << " \""
+            << (can_make_it ? "Can make it!" : "Cannot make it!") << "\"" << '\n';
+    }
+    return true;
+}
+
+vector<pair<ClassKey, int>> CampusCompass::EnrollmentByClass() const {
+    // the rosters already hold the answer
+    vector<pair<ClassKey, int>> enrollment;
+    enrollment.reserve(classes.size());
+    for (int index = 0; index < classes.size(); index++) {
+        enrollment.emplace_back(classes[index].key, (int)rosters[index].size());
+    }
+    return enrollment;
+}
+
+vector<pair<int, int>> CampusCompass::ResidenceHistogram() const {
+    // one pass over the column: residences on the map are counted by dense
+    // index, which is already LocationID order, and any off the map aside
+    const StudentColumns &rows = Columns();
+    vector<int> on_map(graph->LocationCount(), 0);
+    map<int, int> off_map;
+    for (int row = 0; row < rows.size(); row++) {
+        if (rows.ufids[row] == -1) {
+            continue;
+        }
+        int u = graph->DenseIndex(rows.residence_ids[row]);
+        if (u >= 0) {
+            on_map[u]++;
+        } else {
+            off_map[rows.residence_ids[row]]++;
+        }
+    }
+
+    vector<pair<int, int>> histogram;
+    auto aside = off_map.begin();
+    for (int u = 0; u < graph->LocationCount(); u++) {
+        if (on_map[u] == 0) {
+            continue;
+        }
+        for (; aside != off_map.end() && aside->first < graph->LocationId(u); ++aside) {
+            histogram.push_back(*aside);
+        }
+        histogram.emplace_back(graph->LocationId(u), on_map[u]);
+    }
+    histogram.insert(histogram.end(), aside, off_map.end());
+    return histogram;
+}
+
+int CampusCompass::UnmakeableScheduleCount() const {
+    const StudentColumns &rows = Columns();
+    int unmakeable = 0;
+    const ClassInfo *schedule[kMaxClasses];
+    for (int row = 0; row < rows.size(); row++) {
+        int count = 0;
+        const ClassKey *keys = rows.ClassesOf(row);
+        for (int i = 0; i < rows.class_counts[row]; i++) {
+            if (const ClassInfo *info = classes.Get(keys[i])) {
+                schedule[count++] = info;
+            }
+        }
+        SortFew(schedule, schedule + count,
+                [](const ClassInfo *lhs, const ClassInfo *rhs) { return lhs->start < rhs->start; });
+        for (int i = 0; i + 1 < count; i++) {
+            int time = TravelTime(schedule[i]->location_id, schedule[i + 1]->location_id);
+            if (time < 0 || time > schedule[i + 1]->start - schedule[i]->end) {
+                unmakeable++;
+                break;
+            }
+        }
+    }
+    return unmakeable;
+}
@@ -1,15 +1,175 @@
 #pragma once
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Bitset.h"
+#include "CampusGraph.h"
+#include "ClassCatalog.h"
+#include "ContractionHierarchy.h"
+#include "DistanceMatrix.h"
+#include "Landmarks.h"
+#include "LineReader.h"
+#include "OutputSink.h"
+#include "ShortestPath.h"
+#include "StudentTable.h"
+#include "ThreadPool.h"
 
 using namespace std;
 
+// how point-to-point travel times (verifySchedule, TravelTime, and
+// printShortestEdges for the matrix engines) are answered
+enum class PathEngine {
+    SourceTree,    // full shortest path tree from the source, cached and reused
+    Bidirectional, // bidirectional Dijkstra per query, nothing cached
+    Hierarchy,     // upward searches in the contraction hierarchy; bidirectional
+                   // Dijkstra while closures have changed since BuildHierarchy()
+    Landmarks,     // A* with ALT lower bounds from the landmarks picked at load time
+    Matrix,        // all-pairs matrix, recomputed on the first query after a toggle
+    Automatic,     // Matrix if the map has at most a few hundred locations and
+                   // the matrix fits in memory, SourceTree otherwise
+};
+
+// locations settled by the point-to-point searches (Bidirectional and
+// Landmarks engines), for tuning
+struct PathStatistics {
+    long long queries = 0;
+    long long settled = 0;
+};
+
 class CampusCompass {
 private:
-    // Think about what member variables you need to initialize
-    // perhaps some graph representation?
+    shared_ptr<const CampusGraph> graph; // read-only once built, so it can be shared
+    Bitset closed_edges;                 // bit e is set while edge e is closed
+    ClassCatalog classes;
+    StudentTable students;
+    // catalog index -> slots of the enrolled students, in no particular order;
+    // removals swap the last slot into the gap
+    vector<vector<int>> rosters;
+    unique_ptr<FdSink> stdout_sink; // only when no sink was supplied
+    OutputSink *output;             // where results are written right now
+    vector<pair<int, int>> toggle_pairs; // reused by ParseCommand between toggles
+    PathEngine engine = PathEngine::SourceTree;
+    ContractionHierarchy hierarchy;
+    bool hierarchy_current = false; // built with the closures in effect now
+    int landmark_count;
+    LandmarkIndex landmarks;
+    mutable PathStatistics statistics;
+    mutable DistanceMatrix matrix;
+    mutable bool matrix_current = false; // computed with the closures in effect now
+    bool matrix_fits = false;            // whether Automatic picks the matrix for this map
+    mutable unique_ptr<ThreadPool> workers; // started on first use
+    // shortest path trees by dense source index, valid for the current closures
+    mutable unordered_map<int, ShortestPathTree> path_trees;
+
+    bool IsOpen(int edge) const { return !closed_edges.Test(edge); }
+
+    // Shortest path tree from dense index source over open edges. Trees are
+    // cached per source and repaired in place when edges are toggled; the
+    // reference is only good until the next call. Small edge times use a
+    // bucket queue, anything larger a binary heap.
+    const ShortestPathTree &PathTree(int source) const;
+
+    // resets everything derived from the graph and the class catalog after
+    // new ones are loaded
+    void GraphChanged();
+
+    // pool for rebuilding trees and the matrix after closures
+    ThreadPool &Workers() const;
+
+    // the all-pairs matrix if the engine asks for it (built on demand), else
+    // nullptr; also nullptr if travel times are too long for the matrix
+    const DistanceMatrix *CurrentMatrix() const;
+
+    // add classes[i] of the student in slot to its roster / take it off
+    void Enroll(int slot, int i);
+    void Unenroll(int slot, int i);
+    void RemoveIfEmpty(int ufid);
+
+    // runs one command line, writing its result to *output
+    bool Execute(string_view command);
+    // the batch protocol over lines from next_line(string_view &), which
+    // returns false at the end of the input
+    template <typename NextLine>
+    bool RunBatch(NextLine next_line, OutputSink &sink);
+
 public:
-    // Think about what helper functions you will need in the algorithm
-    CampusCompass(); // constructor
+    CampusCompass(); // constructor; results are buffered and written to stdout
+    // results are appended to sink; landmark_count landmarks are picked for
+    // PathEngine::Landmarks whenever a map is loaded
+    explicit CampusCompass(OutputSink &sink, int landmark_count = 0);
     bool ParseCSV(const string &edges_filepath, const string &classes_filepath);
     bool ParseCommand(const string &command);
+    // Runs a whole command stream as read by main: a line with the number of
+    // commands, then one command per line. All results are appended to sink.
+    // Returns false if the first line is not a count.
+    bool ProcessBatch(string_view input, OutputSink &sink);
+    // Same for a pipe or terminal: each command runs as soon as its line has
+    // arrived, output is flushed whenever more input has to be waited for,
+    // and no line past the last announced command is run (the reader may
+    // still have read further ahead, in blocks).
+    bool ProcessStream(LineReader &lines, OutputSink &sink);
+
+    // Binary snapshot of the parsed edges, location names and class table.
+    // LoadSnapshot maps the file and uses the graph arrays in place, so it
+    // replaces ParseCSV for processes that start often. Closures are not saved.
+    // With verify the whole file is hashed and every value range-checked,
+    // for snapshots that were not written by this program.
+    bool SaveSnapshot(const string &snapshot_filepath) const;
+    bool LoadSnapshot(const string &snapshot_filepath, bool verify = false);
+
+    // one member per command; the bool/int results mirror what gets printed
+    // (class codes may be given as text or as already-packed keys)
+    bool Insert(string_view name, int ufid, int residence_id, const vector<string_view> &class_codes);
+    bool Insert(string_view name, int ufid, int residence_id, const ClassKey *class_keys, int class_count);
+    bool Remove(int ufid);
+    bool DropClass(int ufid, string_view class_code);
+    bool DropClass(int ufid, ClassKey key);
+    bool ReplaceClass(int ufid, string_view old_code, string_view new_code);
+    bool ReplaceClass(int ufid, ClassKey old_key, ClassKey new_key);
+    int RemoveClass(string_view class_code); // students affected, -1 if the class does not exist
+    int RemoveClass(ClassKey key);
+    bool ToggleEdgesClosure(const vector<pair<int, int>> &edges);
+    string CheckEdgeStatus(int location_x, int location_y) const; // "open", "closed" or "DNE"
+    bool IsConnected(int location_1, int location_2) const;
+    bool PrintShortestEdges(int ufid);
+    bool PrintStudentZone(int ufid);
+    bool VerifySchedule(int ufid);
+
+    // interned name of a LocationID, empty if the location is not on the map
+    string_view LocationName(int location_id) const { return graph->NameOf(location_id); }
+    // the parsed map; closures are not part of it
+    shared_ptr<const CampusGraph> Graph() const { return graph; }
+    // Selects the point-to-point engine. printStudentZone needs whole trees
+    // and always uses the cached ones.
+    void SetPathEngine(PathEngine path_engine) { engine = path_engine; }
+    // the engine answering queries for this map: the selected one, with
+    // Automatic resolved to Matrix or SourceTree
+    PathEngine ActiveEngine() const {
+        if (engine != PathEngine::Automatic) {
+            return engine;
+        }
+        return matrix_fits ? PathEngine::Matrix : PathEngine::SourceTree;
+    }
+    // Contracts the map with the current closures for PathEngine::Hierarchy.
+    // Optional preprocessing after ParseCSV/LoadSnapshot; call it again after
+    // toggling edges to stop falling back to plain search.
+    void BuildHierarchy();
+    const PathStatistics &Statistics() const { return statistics; }
+    void ResetStatistics() { statistics = PathStatistics(); }
+    // shortest travel time between two LocationIDs over open edges, -1 if unreachable
+    int TravelTime(int from_id, int to_id) const;
+    // total weight of the student's zone MST, -1 if the student does not exist
+    int StudentZoneCost(int ufid) const;
+
+    // Registry reports, streaming the student table's columns.
+    const StudentColumns &Columns() const { return students.Columns(); }
+    // (class key, students enrolled) for every class in the catalog, in key order
+    vector<pair<ClassKey, int>> EnrollmentByClass() const;
+    // (residence LocationID, students living there), in LocationID order
+    vector<pair<int, int>> ResidenceHistogram() const;
+    // students with a pair of consecutive classes they cannot make in time,
+    // as verifySchedule would report it
+    int UnmakeableScheduleCount() const;
 };
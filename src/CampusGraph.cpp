@@ -0,0 +1,219 @@
+#include "CampusGraph.h"
+
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+namespace {
+
+// slot of an unordered LocationID pair in a table of mask + 1 slots
+size_t PairSlot(int location_x, int location_y, size_t mask) {
+    uint64_t lo = (uint32_t)min(location_x, location_y);
+    uint64_t hi = (uint32_t)max(location_x, location_y);
+    return (size_t)(((lo << 32 | hi) * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+
+// whether every value lies in [low, high)
+bool AllInRange(const int *values, size_t count, int low, int high) {
+    for (size_t i = 0; i < count; i++) {
+        if (values[i] < low || values[i] >= high) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void CampusGraph::Build(const vector<vector<RawEdge>> &chunks) {
+    size_t total = 0;
+    for (const vector<RawEdge> &chunk : chunks) {
+        total += chunk.size();
+    }
+    vector<int> ids;
+    ids.reserve(total * 2);
+    for (const vector<RawEdge> &chunk : chunks) {
+        for (const RawEdge &edge : chunk) {
+            ids.push_back(edge.from_id);
+            ids.push_back(edge.to_id);
+        }
+    }
+    sort(ids.begin(), ids.end());
+    ids.erase(unique(ids.begin(), ids.end()), ids.end());
+    location_ids.Assign(move(ids));
+    storage.reset();
+
+    int n = LocationCount();
+    int m = (int)total;
+    NamePool::Builder name_pool(n);
+    vector<int> endpoints(2 * m, 0);
+    vector<int> starts(n + 1, 0);
+
+    // first pass: remap endpoints, name locations on first sight and count degrees
+    int e = 0;
+    for (const vector<RawEdge> &chunk : chunks) {
+        for (const RawEdge &edge : chunk) {
+            int u = DenseIndex(edge.from_id);
+            int v = DenseIndex(edge.to_id);
+            endpoints[2 * e] = u;
+            endpoints[2 * e + 1] = v;
+            starts[u + 1]++;
+            starts[v + 1]++;
+            name_pool.Intern(u, edge.from_name);
+            name_pool.Intern(v, edge.to_name);
+            e++;
+        }
+    }
+    for (int u = 0; u < n; u++) {
+        starts[u + 1] += starts[u];
+    }
+
+    // second pass: scatter both arcs of every edge into place
+    vector<int> arc_targets(starts[n], 0);
+    vector<int> arc_times(starts[n], 0);
+    vector<int> arc_ids(starts[n], 0);
+    vector<int> cursor(starts.begin(), starts.end() - 1);
+    e = 0;
+    for (const vector<RawEdge> &chunk : chunks) {
+        for (const RawEdge &edge : chunk) {
+            int u = endpoints[2 * e];
+            int v = endpoints[2 * e + 1];
+            int arc = cursor[u]++;
+            arc_targets[arc] = v;
+            arc_times[arc] = edge.time;
+            arc_ids[arc] = e;
+            arc = cursor[v]++;
+            arc_targets[arc] = u;
+            arc_times[arc] = edge.time;
+            arc_ids[arc] = e;
+            e++;
+        }
+    }
+
+    names = name_pool.Finish();
+    max_time = arc_times.empty() ? 0 : *max_element(arc_times.begin(), arc_times.end());
+    offsets.Assign(move(starts));
+    neighbors.Assign(move(arc_targets));
+    times.Assign(move(arc_times));
+    arc_edges.Assign(move(arc_ids));
+    edge_endpoints.Assign(move(endpoints));
+
+    // at most half full, so probes stay short and always reach an empty slot
+    size_t capacity = 1;
+    while (capacity < 2 * (size_t)m) {
+        capacity *= 2;
+    }
+    vector<int> table(capacity, -1);
+    for (e = 0; e < m; e++) {
+        int x = LocationId(EdgeSource(e));
+        int y = LocationId(EdgeTarget(e));
+        size_t slot = PairSlot(x, y, capacity - 1);
+        while (table[slot] != -1 && !Joins(table[slot], x, y)) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        if (table[slot] == -1) {
+            table[slot] = e;
+        }
+    }
+    edge_table.Assign(move(table));
+}
+
+void CampusGraph::Save(SnapshotWriter &writer) const {
+    writer.Add(kSectionLocationIds, location_ids.data(), location_ids.size());
+    writer.Add(kSectionOffsets, offsets.data(), offsets.size());
+    writer.Add(kSectionNeighbors, neighbors.data(), neighbors.size());
+    writer.Add(kSectionTimes, times.data(), times.size());
+    writer.Add(kSectionArcEdges, arc_edges.data(), arc_edges.size());
+    writer.Add(kSectionEdgeEndpoints, edge_endpoints.data(), edge_endpoints.size());
+    writer.Add(kSectionEdgeTable, edge_table.data(), edge_table.size());
+    writer.Add(kSectionMaxTime, &max_time, 1);
+    names.Save(writer);
+}
+
+bool CampusGraph::Load(const SnapshotReader &reader) {
+    const int *ids = nullptr, *starts = nullptr, *targets = nullptr, *arc_times = nullptr, *arc_ids = nullptr,
+              *endpoints = nullptr, *table = nullptr, *stored_max_time = nullptr;
+    size_t n = 0, offset_count = 0, arc_count = 0, target_count = 0, time_count = 0, endpoint_count = 0,
+           table_size = 0, max_time_count = 0;
+    if (!reader.Get(kSectionLocationIds, ids, n) || !reader.Get(kSectionOffsets, starts, offset_count) ||
+        !reader.Get(kSectionNeighbors, targets, target_count) || !reader.Get(kSectionTimes, arc_times, time_count) ||
+        !reader.Get(kSectionArcEdges, arc_ids, arc_count) ||
+        !reader.Get(kSectionEdgeEndpoints, endpoints, endpoint_count) ||
+        !reader.Get(kSectionEdgeTable, table, table_size) ||
+        !reader.Get(kSectionMaxTime, stored_max_time, max_time_count)) {
+        return false;
+    }
+    // the edge table needs a power of two size and at least one empty slot
+    if (offset_count != n + 1 || (size_t)starts[n] != arc_count || target_count != arc_count ||
+        time_count != arc_count || arc_count != endpoint_count || table_size == 0 ||
+        (table_size & (table_size - 1)) != 0 || table_size <= endpoint_count / 2 || endpoint_count % 2 != 0 ||
+        max_time_count != 1 || *stored_max_time < 0 || *stored_max_time == INT_MAX || n > (size_t)INT_MAX || arc_count > (size_t)INT_MAX ||
+        !names.Load(reader, n)) {
+        return false;
+    }
+
+    // The arrays are used as raw indices from here on. A snapshot written by
+    // SaveSnapshot is trusted as is, so a plain load reads none of them; a
+    // verified load checks every value once, so a damaged or crafted file
+    // cannot reach out of bounds (or loop forever in FindEdge).
+    if (reader.Verified()) {
+        int location_count = (int)n;
+        int edge_count = (int)(endpoint_count / 2);
+        if (starts[0] != 0 || !AllInRange(targets, arc_count, 0, location_count) ||
+            !AllInRange(arc_times, arc_count, 0, *stored_max_time + 1) ||
+            !AllInRange(arc_ids, arc_count, 0, edge_count) ||
+            !AllInRange(endpoints, endpoint_count, 0, location_count) ||
+            !AllInRange(table, table_size, -1, edge_count) || count(table, table + table_size, -1) == 0) {
+            return false;
+        }
+        for (size_t u = 0; u < n; u++) {
+            if (starts[u] > starts[u + 1] || (u > 0 && ids[u - 1] >= ids[u])) {
+                return false;
+            }
+        }
+    }
+
+    location_ids.Borrow(ids, n);
+    offsets.Borrow(starts, offset_count);
+    neighbors.Borrow(targets, arc_count);
+    times.Borrow(arc_times, arc_count);
+    arc_edges.Borrow(arc_ids, arc_count);
+    edge_endpoints.Borrow(endpoints, endpoint_count);
+    edge_table.Borrow(table, table_size);
+    max_time = *stored_max_time;
+    storage = reader.File();
+    return true;
+}
+
+int CampusGraph::DenseIndex(int location_id) const {
+    const int *it = lower_bound(location_ids.begin(), location_ids.end(), location_id);
+    if (it == location_ids.end() || *it != location_id) {
+        return -1;
+    }
+    return (int)(it - location_ids.begin());
+}
+
+string_view CampusGraph::NameOf(int location_id) const {
+    int u = DenseIndex(location_id);
+    return u < 0 ? string_view() : names[u];
+}
+
+bool CampusGraph::Joins(int e, int location_x, int location_y) const {
+    int a = LocationId(EdgeSource(e));
+    int b = LocationId(EdgeTarget(e));
+    return (a == location_x && b == location_y) || (a == location_y && b == location_x);
+}
+
+int CampusGraph::FindEdge(int location_x, int location_y) const {
+    if (edge_table.size() == 0) {
+        return -1;
+    }
+    size_t mask = edge_table.size() - 1;
+    for (size_t slot = PairSlot(location_x, location_y, mask); edge_table[slot] != -1; slot = (slot + 1) & mask) {
+        if (Joins(edge_table[slot], location_x, location_y)) {
+            return edge_table[slot];
+        }
+    }
+    return -1;
+}
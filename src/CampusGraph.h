@@ -0,0 +1,83 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "FlatArray.h"
+#include "MappedFile.h"
+#include "NamePool.h"
+#include "Snapshot.h"
+
+using namespace std;
+
+// one row of edges.csv, before location IDs are remapped to dense indices;
+// the names point into the loaded file and only need to outlive Build()
+struct RawEdge {
+    int from_id;
+    int to_id;
+    string_view from_name;
+    string_view to_name;
+    int time;
+};
+
+// Immutable compressed sparse row (CSR) campus graph. Nothing about it changes
+// after Build() or Load(), so one instance can be shared between threads;
+// per-query state such as closures lives with the caller.
+// Location IDs are remapped to dense indices [0, LocationCount()) in ascending
+// ID order. Every undirected edge is stored as two arcs (one per endpoint)
+// that share the same edge ID, which is the edge's row index in edges.csv.
+// The arrays are either built by Build() or borrowed from a mapped snapshot.
+class CampusGraph {
+private:
+    FlatArray<int> location_ids;   // dense index -> LocationID (sorted ascending)
+    NamePool names;                // dense index -> location name
+    FlatArray<int> offsets;        // arcs of u are [offsets[u], offsets[u + 1])
+    FlatArray<int> neighbors;      // arc -> dense index of the other endpoint
+    FlatArray<int> times;          // arc -> travel time in minutes
+    FlatArray<int> arc_edges;      // arc -> edge ID
+    FlatArray<int> edge_endpoints; // [2 * e] and [2 * e + 1] are the endpoints of edge e
+    FlatArray<int> edge_table;     // open addressing on the LocationID pair -> edge ID, -1 if empty
+    int max_time = 0;              // largest travel time of any edge
+    shared_ptr<MappedFile> storage; // keeps borrowed arrays alive
+
+    // whether edge e joins the two LocationIDs, in either direction
+    bool Joins(int e, int location_x, int location_y) const;
+
+public:
+    // Replaces the current contents with the graph described by the
+    // concatenation of the edge buffers (one per parsed chunk of edges.csv, in
+    // file order). The buffers are merged with a single counting sort by
+    // source location.
+    void Build(const vector<vector<RawEdge>> &chunks);
+
+    // adds the graph's sections to a snapshot
+    void Save(SnapshotWriter &writer) const;
+    // points the graph at a snapshot's sections; false if they are missing
+    // or inconsistent, in which case the graph is left unchanged
+    bool Load(const SnapshotReader &reader);
+
+    int LocationCount() const { return (int)location_ids.size(); }
+    int EdgeCount() const { return (int)edge_endpoints.size() / 2; }
+    int MaxTime() const { return max_time; }
+
+    // dense index of a LocationID, or -1 if the location is not on the map
+    int DenseIndex(int location_id) const;
+    int LocationId(int u) const { return location_ids[u]; }
+    string_view Name(int u) const { return names[u]; }
+    // name of a LocationID, or an empty view if the location is not on the map
+    string_view NameOf(int location_id) const;
+
+    int ArcBegin(int u) const { return offsets[u]; }
+    int ArcEnd(int u) const { return offsets[u + 1]; }
+    int Neighbor(int arc) const { return neighbors[arc]; }
+    int Time(int arc) const { return times[arc]; }
+    int ArcEdge(int arc) const { return arc_edges[arc]; }
+
+    int EdgeSource(int e) const { return edge_endpoints[2 * e]; }
+    int EdgeTarget(int e) const { return edge_endpoints[2 * e + 1]; }
+
+    // ID of the edge joining two LocationIDs (the first in edges.csv if there
+    // are several), or -1 if there is none; a constant-time hash lookup
+    int FindEdge(int location_x, int location_y) const;
+};
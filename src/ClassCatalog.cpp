@@ -0,0 +1,88 @@
+#include "ClassCatalog.h"
+
+#include <algorithm>
+
+using namespace std;
+
+ClassKey EncodeClassCode(string_view code) {
+    if (code.size() != 7) {
+        return 0;
+    }
+    ClassKey key = 0;
+    for (int i = 0; i < 3; i++) {
+        if (code[i] < 'A' || code[i] > 'Z') {
+            return 0;
+        }
+        key = key * 32 + (ClassKey)(code[i] - 'A' + 1);
+    }
+    ClassKey number = 0;
+    for (int i = 3; i < 7; i++) {
+        if (code[i] < '0' || code[i] > '9') {
+            return 0;
+        }
+        number = number * 10 + (ClassKey)(code[i] - '0');
+    }
+    return key << 14 | number;
+}
+
+string DecodeClassCode(ClassKey key) {
+    return string(ClassCodeText(key).data());
+}
+
+array<char, 8> ClassCodeText(ClassKey key) {
+    array<char, 8> code = {};
+    ClassKey number = key & 0x3FFF;
+    for (int i = 6; i >= 3; i--) {
+        code[i] = (char)('0' + number % 10);
+        number /= 10;
+    }
+    key >>= 14;
+    for (int i = 2; i >= 0; i--) {
+        code[i] = (char)('A' + (key & 31) - 1);
+        key >>= 5;
+    }
+    return code;
+}
+
+void ClassCatalog::Build(vector<ClassInfo> classes) {
+    stable_sort(classes.begin(), classes.end(),
+                [](const ClassInfo &lhs, const ClassInfo &rhs) { return lhs.key < rhs.key; });
+    // keep the last of each run of equal keys
+    vector<ClassInfo> unique_classes;
+    for (size_t i = 0; i < classes.size(); i++) {
+        if (i + 1 == classes.size() || classes[i + 1].key != classes[i].key) {
+            unique_classes.push_back(classes[i]);
+        }
+    }
+    entries.Assign(move(unique_classes));
+    storage.reset();
+}
+
+int ClassCatalog::Find(ClassKey key) const {
+    const ClassInfo *it = lower_bound(entries.begin(), entries.end(), key,
+                                      [](const ClassInfo &info, ClassKey value) { return info.key < value; });
+    if (it == entries.end() || it->key != key) {
+        return -1;
+    }
+    return (int)(it - entries.begin());
+}
+
+void ClassCatalog::Save(SnapshotWriter &writer) const {
+    writer.Add(kSectionClasses, entries.data(), entries.size());
+}
+
+bool ClassCatalog::Load(const SnapshotReader &reader) {
+    const ClassInfo *items = nullptr;
+    size_t count = 0;
+    if (!reader.Get(kSectionClasses, items, count)) {
+        return false;
+    }
+    for (size_t i = 1; reader.Verified() && i < count; i++) {
+        if (items[i - 1].key >= items[i].key) {
+            return false;
+        }
+    }
+    entries.Borrow(items, count);
+    storage = reader.File();
+    return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "FlatArray.h"
+#include "MappedFile.h"
+#include "Snapshot.h"
+
+using namespace std;
+
+// Class codes are three uppercase letters and four digits ("COP3502"). They
+// are packed into 32 bits as 5 bits per letter followed by the number in
+// 14 bits, so comparing keys orders them exactly like comparing the codes.
+// 0 is never a valid key.
+typedef uint32_t ClassKey;
+
+// most classes a student can take
+const int kMaxClasses = 6;
+
+// packed key of a well-formed class code, 0 otherwise
+ClassKey EncodeClassCode(string_view code);
+string DecodeClassCode(ClassKey key);
+// same as DecodeClassCode, as a NUL-terminated array so printing allocates nothing
+array<char, 8> ClassCodeText(ClassKey key);
+
+struct ClassInfo {
+    ClassKey key;
+    int32_t location_id;
+    int32_t start; // minutes since midnight
+    int32_t end;   // minutes since midnight
+};
+
+// classes.csv as a flat array sorted by key; lookups are a binary search over
+// integers. The array is either built from the CSV or borrowed from a snapshot.
+class ClassCatalog {
+private:
+    FlatArray<ClassInfo> entries;
+    shared_ptr<MappedFile> storage; // keeps a borrowed array alive
+
+public:
+    // replaces the catalog; when a key repeats, the last entry wins
+    void Build(vector<ClassInfo> classes);
+
+    int size() const { return (int)entries.size(); }
+    const ClassInfo &operator[](int index) const { return entries[index]; }
+    // index of key in the catalog, or -1
+    int Find(ClassKey key) const;
+    bool Contains(ClassKey key) const { return Find(key) >= 0; }
+    // nullptr if key is not in the catalog, e.g. a class students kept from
+    // before the catalog was reloaded
+    const ClassInfo *Get(ClassKey key) const {
+        int index = Find(key);
+        return index < 0 ? nullptr : &entries[index];
+    }
+
+    void Save(SnapshotWriter &writer) const;
+    bool Load(const SnapshotReader &reader);
+};
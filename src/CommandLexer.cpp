@@ -0,0 +1,186 @@
+#include "CommandLexer.h"
+
+#include "CsvScanner.h"
+
+using namespace std;
+
+namespace {
+
+// cursor over the rest of the line being lexed
+class Cursor {
+private:
+    string_view text;
+
+public:
+    explicit Cursor(string_view line) : text(line) {
+    }
+
+    bool AtEnd() const { return text.empty(); }
+    string_view Rest() const { return text; }
+
+    // consumes a single separating space
+    bool Space() {
+        if (text.empty() || text[0] != ' ') {
+            return false;
+        }
+        text.remove_prefix(1);
+        return true;
+    }
+
+    // run of characters up to the next space or the end of the line
+    string_view Word() {
+        size_t end = text.find(' ');
+        string_view word = text.substr(0, end);
+        text.remove_prefix(word.size());
+        return word;
+    }
+
+    // run of digits; rejects empty runs and runs that are not followed by a
+    // space or the end of the line
+    bool Digits(string_view &digits) {
+        size_t end = 0;
+        while (end < text.size() && text[end] >= '0' && text[end] <= '9') {
+            end++;
+        }
+        if (end == 0 || (end < text.size() && text[end] != ' ')) {
+            return false;
+        }
+        digits = text.substr(0, end);
+        text.remove_prefix(end);
+        return true;
+    }
+
+    bool Number(int &value) {
+        string_view digits;
+        return Digits(digits) && ParseNumber(digits, value);
+    }
+
+    bool Ufid(int &value) {
+        string_view digits;
+        return Digits(digits) && digits.size() == 8 && ParseNumber(digits, value);
+    }
+
+    bool ClassCode(ClassKey &key) {
+        return (key = EncodeClassCode(Word())) != 0;
+    }
+
+    // "letters and spaces", quotes included
+    bool QuotedName(string_view &name) {
+        if (text.empty() || text[0] != '"') {
+            return false;
+        }
+        size_t end = 1;
+        while (end < text.size() && ((text[end] >= 'A' && text[end] <= 'Z') ||
+                                      (text[end] >= 'a' && text[end] <= 'z') || text[end] == ' ')) {
+            end++;
+        }
+        if (end == 1 || end == text.size() || text[end] != '"') {
+            return false;
+        }
+        name = text.substr(1, end - 1);
+        text.remove_prefix(end + 1);
+        return true;
+    }
+};
+
+bool LexVerb(string_view word, CommandVerb &verb) {
+    static const struct {
+        string_view word;
+        CommandVerb verb;
+    } verbs[] = {
+        {"insert", CommandVerb::Insert},
+        {"remove", CommandVerb::Remove},
+        {"dropClass", CommandVerb::DropClass},
+        {"replaceClass", CommandVerb::ReplaceClass},
+        {"removeClass", CommandVerb::RemoveClass},
+        {"toggleEdgesClosure", CommandVerb::ToggleEdgesClosure},
+        {"checkEdgeStatus", CommandVerb::CheckEdgeStatus},
+        {"isConnected", CommandVerb::IsConnected},
+        {"printShortestEdges", CommandVerb::PrintShortestEdges},
+        {"printStudentZone", CommandVerb::PrintStudentZone},
+        {"verifySchedule", CommandVerb::VerifySchedule},
+    };
+    for (const auto &entry : verbs) {
+        if (entry.word == word) {
+            verb = entry.verb;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool LexCommand(string_view line, Command &command) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    Cursor cursor(line);
+    if (!LexVerb(cursor.Word(), command.verb) || !cursor.Space()) {
+        return false;
+    }
+
+    switch (command.verb) {
+    case CommandVerb::Insert: {
+        int declared;
+        if (!cursor.QuotedName(command.name) || !cursor.Space() || !cursor.Ufid(command.ufid) ||
+            !cursor.Space() || !cursor.Number(command.location_1) || !cursor.Space() ||
+            !cursor.Number(declared)) {
+            return false;
+        }
+        command.class_count = 0;
+        while (!cursor.AtEnd()) {
+            if (command.class_count == kMaxClasses || !cursor.Space() ||
+                !cursor.ClassCode(command.classes[command.class_count])) {
+                return false;
+            }
+            command.class_count++;
+        }
+        return command.class_count > 0 && command.class_count == declared;
+    }
+    case CommandVerb::Remove:
+    case CommandVerb::PrintShortestEdges:
+    case CommandVerb::PrintStudentZone:
+    case CommandVerb::VerifySchedule:
+        return cursor.Ufid(command.ufid) && cursor.AtEnd();
+    case CommandVerb::DropClass:
+        command.class_count = 1;
+        return cursor.Ufid(command.ufid) && cursor.Space() && cursor.ClassCode(command.classes[0]) &&
+               cursor.AtEnd();
+    case CommandVerb::ReplaceClass:
+        command.class_count = 2;
+        return cursor.Ufid(command.ufid) && cursor.Space() && cursor.ClassCode(command.classes[0]) &&
+               cursor.Space() && cursor.ClassCode(command.classes[1]) && cursor.AtEnd();
+    case CommandVerb::RemoveClass:
+        command.class_count = 1;
+        return cursor.ClassCode(command.classes[0]) && cursor.AtEnd();
+    case CommandVerb::ToggleEdgesClosure: {
+        if (!cursor.Number(command.pair_count)) {
+            return false;
+        }
+        command.pairs = cursor.Rest();
+        int pairs = 0, x, y;
+        while (!cursor.AtEnd()) {
+            if (!cursor.Space() || !cursor.Number(x) || !cursor.Space() || !cursor.Number(y)) {
+                return false;
+            }
+            pairs++;
+        }
+        return pairs > 0 && pairs == command.pair_count;
+    }
+    case CommandVerb::CheckEdgeStatus:
+    case CommandVerb::IsConnected:
+        return cursor.Number(command.location_1) && cursor.Space() && cursor.Number(command.location_2) &&
+               cursor.AtEnd();
+    }
+    return false;
+}
+
+bool NextLocationPair(string_view &pairs, int &location_x, int &location_y) {
+    Cursor cursor(pairs);
+    if (!cursor.Space() || !cursor.Number(location_x) || !cursor.Space() || !cursor.Number(location_y)) {
+        return false;
+    }
+    pairs = cursor.Rest();
+    return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <string_view>
+
+#include "ClassCatalog.h"
+
+using namespace std;
+
+enum class CommandVerb {
+    Insert,
+    Remove,
+    DropClass,
+    ReplaceClass,
+    RemoveClass,
+    ToggleEdgesClosure,
+    CheckEdgeStatus,
+    IsConnected,
+    PrintShortestEdges,
+    PrintStudentZone,
+    VerifySchedule,
+};
+
+// A well-formed command with its arguments already converted. Views point
+// into the line that was lexed.
+struct Command {
+    CommandVerb verb;
+    string_view name;  // insert
+    int ufid;          // every per-student command
+    int location_1;    // insert (residence), checkEdgeStatus, isConnected
+    int location_2;    // checkEdgeStatus, isConnected
+    int class_count;   // insert, dropClass (1), replaceClass (2), removeClass (1)
+    ClassKey classes[kMaxClasses];
+    int pair_count;    // toggleEdgesClosure
+    string_view pairs; // toggleEdgesClosure: "X Y X Y ...", already validated
+};
+
+// Single-pass lexer for one command line. Arguments are separated by exactly
+// one space; names are quoted and contain only letters and spaces; UFIDs are
+// exactly 8 digits; class codes are three uppercase letters and four digits;
+// other numbers are at most 9 digits. A trailing '\r' is ignored. Returns
+// false for anything else, including an insert whose class count does not
+// match its codes or has more than kMaxClasses of them.
+bool LexCommand(string_view line, Command &command);
+
+// pops the next "X Y" location pair off a validated Command::pairs list
+bool NextLocationPair(string_view &pairs, int &location_x, int &location_y);
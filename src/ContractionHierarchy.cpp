@@ -0,0 +1,233 @@
+#include "ContractionHierarchy.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+// witness searches give up after this many locations; a missed witness only
+// costs a redundant shortcut
+const int kWitnessSettleLimit = 50;
+
+typedef priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> MinHeap;
+
+struct WorkArc {
+    int to;
+    int time;
+};
+
+// the part of the graph that is not contracted yet, shortcuts included
+class Contractor {
+private:
+    vector<vector<WorkArc>> adj;
+    vector<bool> contracted;
+    vector<int> dist; // witness search scratch, -1 when untouched
+    vector<int> touched;
+
+    // Dijkstra from source avoiding via, up to limit minutes
+    void WitnessSearch(int source, int via, int limit) {
+        for (int u : touched) {
+            dist[u] = -1;
+        }
+        touched.clear();
+        MinHeap heap;
+        dist[source] = 0;
+        touched.push_back(source);
+        heap.emplace(0, source);
+        int settled = 0;
+        while (!heap.empty() && settled < kWitnessSettleLimit) {
+            auto [time, u] = heap.top();
+            heap.pop();
+            if (time != dist[u]) {
+                continue;
+            }
+            if (time > limit) {
+                break;
+            }
+            settled++;
+            for (const WorkArc &arc : adj[u]) {
+                int next = time + arc.time;
+                if (arc.to != via && (dist[arc.to] == -1 || next < dist[arc.to])) {
+                    if (dist[arc.to] == -1) {
+                        touched.push_back(arc.to);
+                    }
+                    dist[arc.to] = next;
+                    heap.emplace(next, arc.to);
+                }
+            }
+        }
+    }
+
+public:
+    vector<int> contracted_neighbors;
+
+    explicit Contractor(int n) : adj(n), contracted(n, false), dist(n, -1), contracted_neighbors(n, 0) {
+    }
+
+    // adds an arc in both directions, or lowers the time of an existing one
+    void Connect(int u, int v, int time) {
+        for (auto [from, to] : {pair<int, int>(u, v), pair<int, int>(v, u)}) {
+            auto it = find_if(adj[from].begin(), adj[from].end(), [to = to](const WorkArc &arc) { return arc.to == to; });
+            if (it == adj[from].end()) {
+                adj[from].push_back({to, time});
+            } else {
+                it->time = min(it->time, time);
+            }
+        }
+    }
+
+    const vector<WorkArc> &Arcs(int v) const { return adj[v]; }
+
+    // shortcuts needed to contract v; they are only added if !simulate
+    int Shortcuts(int v, bool simulate) {
+        const vector<WorkArc> arcs = adj[v]; // copy: Connect may grow adj[v]'s neighbours
+        int longest = 0;
+        for (const WorkArc &arc : arcs) {
+            longest = max(longest, arc.time);
+        }
+        int count = 0;
+        for (size_t i = 0; i < arcs.size(); i++) {
+            WitnessSearch(arcs[i].to, v, arcs[i].time + longest);
+            for (size_t j = i + 1; j < arcs.size(); j++) {
+                int through = arcs[i].time + arcs[j].time;
+                int witness = dist[arcs[j].to];
+                if (witness == -1 || witness > through) {
+                    count++;
+                    if (!simulate) {
+                        Connect(arcs[i].to, arcs[j].to, through);
+                    }
+                }
+            }
+        }
+        return count;
+    }
+
+    int Priority(int v) { return Shortcuts(v, true) - (int)adj[v].size() + contracted_neighbors[v]; }
+
+    // removes v from the remaining graph
+    void Remove(int v) {
+        for (const WorkArc &arc : adj[v]) {
+            vector<WorkArc> &back = adj[arc.to];
+            back.erase(find_if(back.begin(), back.end(), [v](const WorkArc &other) { return other.to == v; }));
+            contracted_neighbors[arc.to]++;
+        }
+        contracted[v] = true;
+        adj[v].clear();
+        adj[v].shrink_to_fit();
+    }
+};
+
+// per-thread query scratch, so Query() stays const and reentrant
+struct QuerySpace {
+    vector<int> dist[2]; // -1 when untouched
+    vector<int> touched;
+};
+
+} // namespace
+
+void ContractionHierarchy::Build(const CampusGraph &graph, const Bitset &closed_edges) {
+    int n = graph.LocationCount();
+    Contractor contractor(n);
+    for (int u = 0; u < n; u++) {
+        for (int arc = graph.ArcBegin(u); arc < graph.ArcEnd(u); arc++) {
+            int v = graph.Neighbor(arc);
+            if (u < v && !closed_edges.Test(graph.ArcEdge(arc))) {
+                contractor.Connect(u, v, graph.Time(arc));
+            }
+        }
+    }
+
+    // lazy updates: a popped location is only contracted if its refreshed
+    // priority is still the smallest
+    MinHeap order;
+    for (int v = 0; v < n; v++) {
+        order.emplace(contractor.Priority(v), v);
+    }
+    rank.assign(n, -1);
+    vector<vector<WorkArc>> upward(n);
+    shortcut_count = 0;
+    int next_rank = 0;
+    while (!order.empty()) {
+        int v = order.top().second;
+        order.pop();
+        if (rank[v] != -1) {
+            continue;
+        }
+        int priority = contractor.Priority(v);
+        if (!order.empty() && priority > order.top().first) {
+            order.emplace(priority, v);
+            continue;
+        }
+        shortcut_count += contractor.Shortcuts(v, false);
+        upward[v] = contractor.Arcs(v);
+        contractor.Remove(v);
+        rank[v] = next_rank++;
+    }
+
+    up_offsets.assign(n + 1, 0);
+    up_neighbors.clear();
+    up_times.clear();
+    for (int u = 0; u < n; u++) {
+        for (const WorkArc &arc : upward[u]) {
+            up_neighbors.push_back(arc.to);
+            up_times.push_back(arc.time);
+        }
+        up_offsets[u + 1] = (int)up_neighbors.size();
+    }
+}
+
+int ContractionHierarchy::Query(int source, int target) const {
+    int n = (int)rank.size();
+    thread_local QuerySpace space;
+    for (vector<int> &dist : space.dist) {
+        if ((int)dist.size() != n) {
+            dist.assign(n, -1);
+        }
+    }
+
+    // forward search runs to completion; the backward one stops once it
+    // cannot beat the best meeting point
+    int shortest = -1;
+    int starts[2] = {source, target};
+    for (int side = 0; side < 2; side++) {
+        vector<int> &dist = space.dist[side];
+        const vector<int> &other = space.dist[side ^ 1];
+        MinHeap heap;
+        dist[starts[side]] = 0;
+        space.touched.push_back(starts[side]);
+        heap.emplace(0, starts[side]);
+        while (!heap.empty()) {
+            auto [time, u] = heap.top();
+            heap.pop();
+            if (time != dist[u]) {
+                continue;
+            }
+            if (side == 1 && shortest != -1 && time >= shortest) {
+                break;
+            }
+            if (side == 1 && other[u] != -1 && (shortest == -1 || time + other[u] < shortest)) {
+                shortest = time + other[u];
+            }
+            for (int arc = up_offsets[u]; arc < up_offsets[u + 1]; arc++) {
+                int v = up_neighbors[arc];
+                int next = time + up_times[arc];
+                if (dist[v] == -1 || next < dist[v]) {
+                    dist[v] = next;
+                    space.touched.push_back(v);
+                    heap.emplace(next, v);
+                }
+            }
+        }
+    }
+
+    for (int u : space.touched) {
+        space.dist[0][u] = -1;
+        space.dist[1][u] = -1;
+    }
+    space.touched.clear();
+    return shortest;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+
+#include "Bitset.h"
+#include "CampusGraph.h"
+
+using namespace std;
+
+// Contraction hierarchy over the open edges of a CampusGraph.
+//
+// Build() contracts locations one at a time in order of importance (edge
+// difference plus contracted neighbours, updated lazily), adding a shortcut
+// between two neighbours of the contracted location whenever a bounded
+// witness search finds no path at least as short that avoids it. Every
+// location keeps only the arcs to locations contracted after it, so a query
+// is two upward searches that meet at the highest-ranked location on the
+// shortest path. The graph is undirected, so one upward graph serves both
+// directions.
+//
+// The hierarchy reflects the closures it was built with; rebuild it when they
+// change.
+class ContractionHierarchy {
+private:
+    vector<int> rank;         // dense index -> contraction order
+    vector<int> up_offsets;   // upward arcs of u are [up_offsets[u], up_offsets[u + 1])
+    vector<int> up_neighbors; // arc -> dense index of a higher-ranked location
+    vector<int> up_times;     // arc -> travel time (of an edge or a shortcut)
+    int shortcut_count = 0;
+
+public:
+    // contracts every location of graph, ignoring the edges set in closed_edges
+    void Build(const CampusGraph &graph, const Bitset &closed_edges);
+
+    bool Empty() const { return rank.empty(); }
+    int ShortcutCount() const { return shortcut_count; }
+    int Rank(int u) const { return rank[u]; }
+
+    // travel time between dense indices source and target, -1 if unreachable;
+    // safe to call from several threads at once
+    int Query(int source, int target) const;
+};
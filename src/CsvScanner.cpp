@@ -0,0 +1,207 @@
+#include "CsvScanner.h"
+
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CAMPUS_COMPASS_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+// bit i of the result is set when block[i] is ',' or '\n'
+typedef uint64_t (*MaskKernel)(const char *block);
+
+uint64_t ScalarMask(const char *block) {
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i++) {
+        if (block[i] == ',' || block[i] == '\n') {
+            mask |= uint64_t(1) << i;
+        }
+    }
+    return mask;
+}
+
+#ifdef CAMPUS_COMPASS_X86_KERNELS
+
+__attribute__((target("sse2"))) uint64_t Sse2Mask(const char *block) {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(bytes, comma), _mm_cmpeq_epi8(bytes, newline));
+        mask |= uint64_t((uint32_t)_mm_movemask_epi8(hits)) << i;
+    }
+    return mask;
+}
+
+__attribute__((target("avx2"))) uint64_t Avx2Mask(const char *block) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+    __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 32));
+    __m256i low_hits = _mm256_or_si256(_mm256_cmpeq_epi8(low, comma), _mm256_cmpeq_epi8(low, newline));
+    __m256i high_hits = _mm256_or_si256(_mm256_cmpeq_epi8(high, comma), _mm256_cmpeq_epi8(high, newline));
+    return uint64_t((uint32_t)_mm256_movemask_epi8(low_hits)) |
+           (uint64_t((uint32_t)_mm256_movemask_epi8(high_hits)) << 32);
+}
+
+#endif
+
+struct Kernel {
+    MaskKernel mask;
+    const char *name;
+};
+
+Kernel SelectKernel() {
+#ifdef CAMPUS_COMPASS_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {Avx2Mask, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return {Sse2Mask, "sse2"};
+    }
+#endif
+    return {ScalarMask, "scalar"};
+}
+
+const Kernel &ActiveKernel() {
+    static const Kernel kernel = SelectKernel();
+    return kernel;
+}
+
+int CountTrailingZeros(uint64_t mask) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(mask);
+#else
+    int count = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+// mask for the block at offset; the final partial block is copied into a
+// zero-padded buffer so the kernels never read past the input
+uint64_t BlockMask(const char *text, size_t size, size_t offset) {
+    if (offset + 64 <= size) {
+        return ActiveKernel().mask(text + offset);
+    }
+    char padded[64] = {};
+    memcpy(padded, text + offset, size - offset);
+    return ActiveKernel().mask(padded);
+}
+
+bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+} // namespace
+
+CsvScanner::CsvScanner(string_view input) : text(input.data()), size(input.size()) {
+    if (size > 0) {
+        mask = BlockMask(text, size, 0);
+    }
+}
+
+const char *CsvScanner::KernelName() {
+    return ActiveKernel().name;
+}
+
+bool CsvScanner::NextField(string_view &field, bool &end_of_line) {
+    if (field_start >= size) {
+        return false;
+    }
+    while (mask == 0) {
+        block += 64;
+        if (block >= size) {
+            // last line has no trailing newline
+            field = string_view(text + field_start, size - field_start);
+            field_start = size;
+            end_of_line = true;
+            return true;
+        }
+        mask = BlockMask(text, size, block);
+    }
+    size_t delimiter = block + CountTrailingZeros(mask);
+    mask &= mask - 1;
+    field = string_view(text + field_start, delimiter - field_start);
+    end_of_line = text[delimiter] == '\n';
+    field_start = delimiter + 1;
+    return true;
+}
+
+int CsvScanner::NextRow(string_view *fields, int max_fields) {
+    string_view field;
+    bool end_of_line = false;
+    int count = 0;
+    while (NextField(field, end_of_line)) {
+        if (count < max_fields) {
+            fields[count] = field;
+        }
+        count++;
+        if (!end_of_line) {
+            continue;
+        }
+        if (count <= max_fields && !fields[count - 1].empty() && fields[count - 1].back() == '\r') {
+            fields[count - 1].remove_suffix(1);
+        }
+        if (count == 1 && fields[0].empty()) {
+            count = 0; // blank line
+            continue;
+        }
+        return count > max_fields ? max_fields + 1 : count;
+    }
+    return count > max_fields ? max_fields + 1 : count;
+}
+
+bool ParseNumber(string_view text, int &value) {
+    size_t length = text.size();
+    if (length == 0 || length > 9) {
+        return false;
+    }
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (length >= 4 && length <= 8) {
+        // SWAR: left-pad with '0's to 8 bytes, validate and convert all of them at once
+        uint64_t chunk = 0x3030303030303030ULL;
+        memcpy(reinterpret_cast<char *>(&chunk) + (8 - length), text.data(), length);
+        uint64_t high_nibbles = chunk & 0xF0F0F0F0F0F0F0F0ULL;
+        uint64_t carry_check = (chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL;
+        if (high_nibbles != 0x3030303030303030ULL || carry_check != 0x3030303030303030ULL) {
+            return false;
+        }
+        chunk = (chunk & 0x0F0F0F0F0F0F0F0FULL) * 2561 >> 8;
+        chunk = (chunk & 0x00FF00FF00FF00FFULL) * 6553601 >> 16;
+        value = (int)((chunk & 0x0000FFFF0000FFFFULL) * 42949672960001ULL >> 32);
+        return true;
+    }
+#endif
+    value = 0;
+    for (char c : text) {
+        if (!IsDigit(c)) {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+bool ParseClock(string_view text, int &minutes) {
+    if (text.size() != 5 || text[2] != ':' || !IsDigit(text[0]) || !IsDigit(text[1]) ||
+        !IsDigit(text[3]) || !IsDigit(text[4])) {
+        return false;
+    }
+    int hours = (text[0] - '0') * 10 + (text[1] - '0');
+    int mins = (text[3] - '0') * 10 + (text[4] - '0');
+    if (hours > 23 || mins > 59) {
+        return false;
+    }
+    minutes = hours * 60 + mins;
+    return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+using namespace std;
+
+// Walks a CSV buffer one row at a time. Delimiters (',' and '\n') are located
+// 64 bytes at a time with SIMD compares (AVX2 or SSE2, picked at runtime, with
+// a scalar fallback) and kept as a bitmask, so short numeric fields cost a
+// couple of bit operations instead of a byte-at-a-time loop. Quoting is not
+// supported; neither campus file uses it.
+class CsvScanner {
+private:
+    const char *text;
+    size_t size;
+    size_t block = 0;       // offset of the 64-byte block that mask describes
+    uint64_t mask = 0;      // delimiters in the current block not consumed yet
+    size_t field_start = 0; // offset of the first byte of the next field
+
+    // next field, and whether a newline (or the end of input) terminated it;
+    // returns false once the input is exhausted
+    bool NextField(string_view &field, bool &end_of_line);
+
+public:
+    explicit CsvScanner(string_view input);
+
+    // Reads the next non-blank row into fields and returns how many fields it
+    // had; rows longer than max_fields are consumed whole and reported as
+    // max_fields + 1. Returns 0 at the end of input. A trailing '\r' is
+    // stripped from the last field.
+    int NextRow(string_view *fields, int max_fields);
+
+    // name of the delimiter kernel picked for this CPU ("avx2", "sse2" or "scalar")
+    static const char *KernelName();
+};
+
+// non-negative decimal integer of at most 9 digits, so it always fits in an int
+bool ParseNumber(string_view text, int &value);
+
+// fixed-format "HH:MM" -> minutes since midnight
+bool ParseClock(string_view text, int &minutes);
@@ -0,0 +1,355 @@
+#include "DistanceMatrix.h"
+#include "ShortestPath.h"
+
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CAMPUS_COMPASS_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+// "unreachable"; twice either still fits the cell type, so sums never overflow
+const int16_t kNarrowInfinity = 0x3FFF;
+const int32_t kWideInfinity = 0x3FFFFFFF;
+
+// side of the square tiles the matrix is processed in
+const size_t kBlock = 64;
+
+// For one tile: c[i][j] = min(c[i][j], a[i][k] + b[k][j]) with k outermost.
+// a and b may be c itself, as in the diagonal and cross phases: row and
+// column k of a tile do not change while k is being applied, because the
+// diagonal is zero.
+template <typename T>
+void ScalarMinPlus(T *c, const T *a, const T *b, size_t stride) {
+    for (size_t k = 0; k < kBlock; k++) {
+        const T *b_row = b + k * stride;
+        for (size_t i = 0; i < kBlock; i++) {
+            T a_ik = a[i * stride + k];
+            T *c_row = c + i * stride;
+            for (size_t j = 0; j < kBlock; j++) {
+                c_row[j] = min(c_row[j], (T)(a_ik + b_row[j]));
+            }
+        }
+    }
+}
+
+// Same update for a tile that neither a nor b overlaps (the bulk of the
+// work), so the order is free: each row of c stays in registers while all of
+// k is applied to it.
+template <typename T>
+void ScalarMinPlusDisjoint(T *c, const T *a, const T *b, size_t stride) {
+    for (size_t i = 0; i < kBlock; i++) {
+        T row[kBlock];
+        copy(c + i * stride, c + i * stride + kBlock, row);
+        for (size_t k = 0; k < kBlock; k++) {
+            T a_ik = a[i * stride + k];
+            const T *b_row = b + k * stride;
+            for (size_t j = 0; j < kBlock; j++) {
+                row[j] = min(row[j], (T)(a_ik + b_row[j]));
+            }
+        }
+        copy(row, row + kBlock, c + i * stride);
+    }
+}
+
+#ifdef CAMPUS_COMPASS_X86_KERNELS
+
+__attribute__((target("sse2"))) void Sse2MinPlus16(int16_t *c, const int16_t *a, const int16_t *b, size_t stride) {
+    for (size_t k = 0; k < kBlock; k++) {
+        const int16_t *b_row = b + k * stride;
+        for (size_t i = 0; i < kBlock; i++) {
+            __m128i a_ik = _mm_set1_epi16(a[i * stride + k]);
+            int16_t *c_row = c + i * stride;
+            for (size_t j = 0; j < kBlock; j += 8) {
+                __m128i *cell = reinterpret_cast<__m128i *>(c_row + j);
+                __m128i through = _mm_add_epi16(a_ik, _mm_loadu_si128(reinterpret_cast<const __m128i *>(b_row + j)));
+                _mm_storeu_si128(cell, _mm_min_epi16(_mm_loadu_si128(cell), through));
+            }
+        }
+    }
+}
+
+__attribute__((target("avx2"))) void Avx2MinPlus16(int16_t *c, const int16_t *a, const int16_t *b, size_t stride) {
+    for (size_t k = 0; k < kBlock; k++) {
+        const int16_t *b_row = b + k * stride;
+        for (size_t i = 0; i < kBlock; i++) {
+            __m256i a_ik = _mm256_set1_epi16(a[i * stride + k]);
+            int16_t *c_row = c + i * stride;
+            for (size_t j = 0; j < kBlock; j += 16) {
+                __m256i *cell = reinterpret_cast<__m256i *>(c_row + j);
+                __m256i through =
+                    _mm256_add_epi16(a_ik, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b_row + j)));
+                _mm256_storeu_si256(cell, _mm256_min_epi16(_mm256_loadu_si256(cell), through));
+            }
+        }
+    }
+}
+
+__attribute__((target("avx2"))) void Avx2MinPlus32(int32_t *c, const int32_t *a, const int32_t *b, size_t stride) {
+    for (size_t k = 0; k < kBlock; k++) {
+        const int32_t *b_row = b + k * stride;
+        for (size_t i = 0; i < kBlock; i++) {
+            __m256i a_ik = _mm256_set1_epi32(a[i * stride + k]);
+            int32_t *c_row = c + i * stride;
+            for (size_t j = 0; j < kBlock; j += 8) {
+                __m256i *cell = reinterpret_cast<__m256i *>(c_row + j);
+                __m256i through =
+                    _mm256_add_epi32(a_ik, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b_row + j)));
+                _mm256_storeu_si256(cell, _mm256_min_epi32(_mm256_loadu_si256(cell), through));
+            }
+        }
+    }
+}
+
+__attribute__((target("sse2"))) void Sse2MinPlus16Disjoint(int16_t *c, const int16_t *a, const int16_t *b,
+                                                            size_t stride) {
+    for (size_t i = 0; i < kBlock; i++) {
+        __m128i row[kBlock / 8];
+        for (size_t v = 0; v < kBlock / 8; v++) {
+            row[v] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(c + i * stride + v * 8));
+        }
+        for (size_t k = 0; k < kBlock; k++) {
+            __m128i a_ik = _mm_set1_epi16(a[i * stride + k]);
+            const int16_t *b_row = b + k * stride;
+            for (size_t v = 0; v < kBlock / 8; v++) {
+                __m128i through = _mm_add_epi16(a_ik, _mm_loadu_si128(reinterpret_cast<const __m128i *>(b_row + v * 8)));
+                row[v] = _mm_min_epi16(row[v], through);
+            }
+        }
+        for (size_t v = 0; v < kBlock / 8; v++) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(c + i * stride + v * 8), row[v]);
+        }
+    }
+}
+
+__attribute__((target("avx2"))) void Avx2MinPlus16Disjoint(int16_t *c, const int16_t *a, const int16_t *b,
+                                                            size_t stride) {
+    for (size_t i = 0; i < kBlock; i++) {
+        __m256i row[kBlock / 16];
+        for (size_t v = 0; v < kBlock / 16; v++) {
+            row[v] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(c + i * stride + v * 16));
+        }
+        for (size_t k = 0; k < kBlock; k++) {
+            __m256i a_ik = _mm256_set1_epi16(a[i * stride + k]);
+            const int16_t *b_row = b + k * stride;
+            for (size_t v = 0; v < kBlock / 16; v++) {
+                __m256i through =
+                    _mm256_add_epi16(a_ik, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b_row + v * 16)));
+                row[v] = _mm256_min_epi16(row[v], through);
+            }
+        }
+        for (size_t v = 0; v < kBlock / 16; v++) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(c + i * stride + v * 16), row[v]);
+        }
+    }
+}
+
+__attribute__((target("avx2"))) void Avx2MinPlus32Disjoint(int32_t *c, const int32_t *a, const int32_t *b,
+                                                            size_t stride) {
+    for (size_t i = 0; i < kBlock; i++) {
+        __m256i row[kBlock / 8];
+        for (size_t v = 0; v < kBlock / 8; v++) {
+            row[v] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(c + i * stride + v * 8));
+        }
+        for (size_t k = 0; k < kBlock; k++) {
+            __m256i a_ik = _mm256_set1_epi32(a[i * stride + k]);
+            const int32_t *b_row = b + k * stride;
+            for (size_t v = 0; v < kBlock / 8; v++) {
+                __m256i through =
+                    _mm256_add_epi32(a_ik, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b_row + v * 8)));
+                row[v] = _mm256_min_epi32(row[v], through);
+            }
+        }
+        for (size_t v = 0; v < kBlock / 8; v++) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(c + i * stride + v * 8), row[v]);
+        }
+    }
+}
+
+#endif
+
+template <typename T>
+struct MinPlus {
+    void (*in_place)(T *c, const T *a, const T *b, size_t stride);
+    void (*disjoint)(T *c, const T *a, const T *b, size_t stride);
+};
+
+// SSE2 has no 32-bit min, so that level keeps the scalar int32 kernels
+struct Kernel {
+    MinPlus<int16_t> min_plus_16;
+    MinPlus<int32_t> min_plus_32;
+    const char *name;
+};
+
+Kernel SelectKernel() {
+#ifdef CAMPUS_COMPASS_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {{Avx2MinPlus16, Avx2MinPlus16Disjoint}, {Avx2MinPlus32, Avx2MinPlus32Disjoint}, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return {{Sse2MinPlus16, Sse2MinPlus16Disjoint},
+                {ScalarMinPlus<int32_t>, ScalarMinPlusDisjoint<int32_t>},
+                "sse2"};
+    }
+#endif
+    return {{ScalarMinPlus<int16_t>, ScalarMinPlusDisjoint<int16_t>},
+            {ScalarMinPlus<int32_t>, ScalarMinPlusDisjoint<int32_t>},
+            "scalar"};
+}
+
+const Kernel &ActiveKernel() {
+    static const Kernel kernel = SelectKernel();
+    return kernel;
+}
+
+size_t PaddedSize(int location_count) {
+    return (location_count + kBlock - 1) / kBlock * kBlock;
+}
+
+// Fills cells with the direct edge times and runs the three phases of blocked
+// Floyd-Warshall for every diagonal tile: the tile itself, then its row and
+// column of tiles, then everything else.
+template <typename T>
+void FloydWarshall(const CampusGraph &graph, const Bitset &closed_edges, size_t stride, T infinity,
+                   vector<T> &cells, const MinPlus<T> &min_plus) {
+    cells.assign(stride * stride, infinity);
+    for (size_t u = 0; u < stride; u++) {
+        cells[u * stride + u] = 0;
+    }
+    for (int u = 0; u < graph.LocationCount(); u++) {
+        for (int arc = graph.ArcBegin(u); arc < graph.ArcEnd(u); arc++) {
+            if (!closed_edges.Test(graph.ArcEdge(arc))) {
+                T &cell = cells[(size_t)u * stride + graph.Neighbor(arc)];
+                cell = min(cell, (T)graph.Time(arc));
+            }
+        }
+    }
+
+    size_t blocks = stride / kBlock;
+    auto tile = [&](size_t row, size_t column) { return cells.data() + row * kBlock * stride + column * kBlock; };
+    for (size_t k = 0; k < blocks; k++) {
+        min_plus.in_place(tile(k, k), tile(k, k), tile(k, k), stride);
+        for (size_t j = 0; j < blocks; j++) {
+            if (j != k) {
+                min_plus.in_place(tile(k, j), tile(k, k), tile(k, j), stride);
+                min_plus.in_place(tile(j, k), tile(j, k), tile(k, k), stride);
+            }
+        }
+        for (size_t i = 0; i < blocks; i++) {
+            for (size_t j = 0; j < blocks; j++) {
+                if (i != k && j != k) {
+                    min_plus.disjoint(tile(i, j), tile(i, k), tile(k, j), stride);
+                }
+            }
+        }
+    }
+}
+
+// one row per source from a Dijkstra search, sources spread over pool
+template <typename T>
+void SearchRows(const CampusGraph &graph, const Bitset &closed_edges, size_t stride, T infinity, vector<T> &cells,
+                ThreadPool &pool) {
+    cells.assign(stride * stride, infinity);
+    for (size_t u = graph.LocationCount(); u < stride; u++) {
+        cells[u * stride + u] = 0;
+    }
+    T *rows = cells.data();
+    for (int source = 0; source < graph.LocationCount(); source++) {
+        pool.Submit([&graph, &closed_edges, stride, rows, source] {
+            auto is_open = [&closed_edges](int edge) { return !closed_edges.Test(edge); };
+            ShortestPathTree tree;
+            if (graph.MaxTime() <= kMaxBucketWeight) {
+                Dijkstra<BucketQueue>(graph, source, -1, is_open, tree);
+            } else {
+                Dijkstra<BinaryHeapQueue>(graph, source, -1, is_open, tree);
+            }
+            T *row = rows + (size_t)source * stride;
+            for (int v = 0; v < graph.LocationCount(); v++) {
+                if (tree.dist[v] != kUnreachable) {
+                    row[v] = (T)tree.dist[v];
+                }
+            }
+        });
+    }
+    pool.Wait();
+}
+
+// longest possible shortest path: one through every location on the longest edge
+long long PathBound(const CampusGraph &graph) {
+    return (long long)max(graph.LocationCount() - 1, 0) * graph.MaxTime();
+}
+
+} // namespace
+
+bool DistanceMatrix::Build(const CampusGraph &graph, const Bitset &closed_edges, ThreadPool *pool) {
+    long long bound = PathBound(graph);
+    if (graph.LocationCount() == 0 || bound >= kWideInfinity) {
+        Clear();
+        return false;
+    }
+    location_count = graph.LocationCount();
+    stride = PaddedSize(location_count);
+    narrow = bound < kNarrowInfinity;
+    // rebuilding at the same size reuses the cells
+    if (narrow) {
+        wide_cells = vector<int32_t>();
+        if (pool) {
+            SearchRows(graph, closed_edges, stride, kNarrowInfinity, narrow_cells, *pool);
+        } else {
+            FloydWarshall(graph, closed_edges, stride, kNarrowInfinity, narrow_cells, ActiveKernel().min_plus_16);
+        }
+    } else {
+        narrow_cells = vector<int16_t>();
+        if (pool) {
+            SearchRows(graph, closed_edges, stride, kWideInfinity, wide_cells, *pool);
+        } else {
+            FloydWarshall(graph, closed_edges, stride, kWideInfinity, wide_cells, ActiveKernel().min_plus_32);
+        }
+    }
+    return true;
+}
+
+void DistanceMatrix::Clear() {
+    location_count = 0;
+    stride = 0;
+    narrow = false;
+    narrow_cells = vector<int16_t>();
+    wide_cells = vector<int32_t>();
+}
+
+int DistanceMatrix::At(int u, int v) const {
+    size_t cell = (size_t)u * stride + v;
+    if (narrow) {
+        return narrow_cells[cell] >= kNarrowInfinity ? -1 : narrow_cells[cell];
+    }
+    return wide_cells[cell] >= kWideInfinity ? -1 : wide_cells[cell];
+}
+
+size_t DistanceMatrix::BytesNeeded(const CampusGraph &graph) {
+    size_t padded = PaddedSize(graph.LocationCount());
+    return padded * padded * (PathBound(graph) < kNarrowInfinity ? sizeof(int16_t) : sizeof(int32_t));
+}
+
+size_t DistanceMatrix::AvailableMemory() {
+#if defined(_SC_AVPHYS_PAGES) && defined(_SC_PAGESIZE)
+    long pages = sysconf(_SC_AVPHYS_PAGES);
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && page_size > 0) {
+        return (size_t)pages * (size_t)page_size;
+    }
+#endif
+    return 0;
+}
+
+const char *DistanceMatrix::KernelName() {
+    return ActiveKernel().name;
+}
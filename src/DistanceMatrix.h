@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Bitset.h"
+#include "CampusGraph.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+// All-pairs travel times over the open edges of a CampusGraph, computed with
+// a cache-blocked Floyd-Warshall and stored row-major, so every query is a
+// single load. Cells are int16 whenever no shortest path can reach the int16
+// "infinity" (fewer than 16383 minutes even along a path through every
+// location), which halves the memory and doubles the SIMD lanes; int32
+// otherwise. The min-plus kernels are picked for the CPU like CsvScanner's.
+// Given a thread pool, rows are instead filled by independent Dijkstra
+// searches, one task per source location.
+class DistanceMatrix {
+private:
+    int location_count = 0;
+    size_t stride = 0; // row length, location_count rounded up to whole blocks
+    bool narrow = false;
+    vector<int16_t> narrow_cells;
+    vector<int32_t> wide_cells;
+
+public:
+    // computes every travel time with the edges in closed_edges removed;
+    // false (leaving the matrix empty) if times could overflow int32 cells
+    bool Build(const CampusGraph &graph, const Bitset &closed_edges, ThreadPool *pool = nullptr);
+    void Clear();
+
+    bool Empty() const { return location_count == 0; }
+    bool IsNarrow() const { return narrow; }
+
+    // travel time between dense indices u and v, -1 if unreachable
+    int At(int u, int v) const;
+
+    // bytes a matrix over this graph takes
+    static size_t BytesNeeded(const CampusGraph &graph);
+    // physical memory not in use right now, 0 if the platform cannot tell
+    static size_t AvailableMemory();
+    // name of the min-plus kernel picked for this CPU ("avx2", "sse2" or "scalar")
+    static const char *KernelName();
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// Read-only contiguous array that either owns its elements or borrows them
+// from memory that lives somewhere else (e.g. a memory-mapped snapshot).
+// The owner of borrowed memory is responsible for keeping it alive.
+template <typename T>
+class FlatArray {
+private:
+    vector<T> owned;
+    const T *items = nullptr;
+    size_t count = 0;
+    bool borrowed = false;
+
+public:
+    FlatArray() = default;
+    FlatArray(const FlatArray &other)
+        : owned(other.owned), items(other.borrowed ? other.items : owned.data()), count(other.count),
+          borrowed(other.borrowed) {
+    }
+    FlatArray &operator=(const FlatArray &other) {
+        if (this != &other) {
+            owned = other.owned;
+            items = other.borrowed ? other.items : owned.data();
+            count = other.count;
+            borrowed = other.borrowed;
+        }
+        return *this;
+    }
+    // moving a vector keeps its buffer, so items stays valid either way
+    FlatArray(FlatArray &&other) noexcept
+        : owned(move(other.owned)), items(other.items), count(other.count), borrowed(other.borrowed) {
+    }
+    FlatArray &operator=(FlatArray &&other) noexcept {
+        owned = move(other.owned);
+        items = other.items;
+        count = other.count;
+        borrowed = other.borrowed;
+        return *this;
+    }
+
+    void Assign(vector<T> values) {
+        owned = move(values);
+        items = owned.data();
+        count = owned.size();
+        borrowed = false;
+    }
+
+    void Borrow(const T *values, size_t size) {
+        owned.clear();
+        owned.shrink_to_fit();
+        items = values;
+        count = size;
+        borrowed = true;
+    }
+
+    const T &operator[](size_t i) const { return items[i]; }
+    const T *data() const { return items; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const T *begin() const { return items; }
+    const T *end() const { return items + count; }
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+
+using namespace std;
+
+// Vector of at most Capacity trivially copyable elements stored in place, so
+// it never allocates and copying it is a memcpy. Going past Capacity is the
+// caller's bug and is not checked.
+template <typename T, int Capacity>
+class InlineVector {
+private:
+    T items[Capacity];
+    uint8_t count = 0;
+
+public:
+    static_assert(Capacity <= 255, "count is a byte");
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    T &operator[](int i) { return items[i]; }
+    const T &operator[](int i) const { return items[i]; }
+    T *begin() { return items; }
+    T *end() { return items + count; }
+    const T *begin() const { return items; }
+    const T *end() const { return items + count; }
+
+    void push_back(T value) { items[count++] = value; }
+
+    // shifts the elements from pos on one place to the right
+    T *insert(T *pos, T value) {
+        for (T *it = end(); it != pos; --it) {
+            *it = *(it - 1);
+        }
+        *pos = value;
+        count++;
+        return pos;
+    }
+
+    // shifts the elements after pos one place to the left
+    T *erase(T *pos) {
+        for (T *it = pos; it + 1 != end(); ++it) {
+            *it = *(it + 1);
+        }
+        count--;
+        return pos;
+    }
+};
@@ -0,0 +1,125 @@
+#include "Landmarks.h"
+#include "ShortestPath.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+using namespace std;
+
+namespace {
+
+// A* keyed on travel time so far plus lower_bound(v). The bound is consistent,
+// so every key pushed is at most twice the largest edge time past the key
+// being settled and the bucket queue can be used like in Dijkstra.
+template <typename Queue, typename LowerBound>
+int AStar(const CampusGraph &graph, const Bitset &closed_edges, int source, int target, const LowerBound &lower_bound,
+          int *settled) {
+    int n = graph.LocationCount();
+    vector<int> best(n, kUnreachable);
+    vector<bool> done(n, false);
+    Queue queue(2 * graph.MaxTime());
+    best[source] = 0;
+    queue.Push(lower_bound(source), source);
+    while (!queue.Empty()) {
+        int u = queue.Pop().second;
+        if (done[u]) {
+            continue;
+        }
+        done[u] = true;
+        if (settled) {
+            (*settled)++;
+        }
+        if (u == target) {
+            return best[u];
+        }
+        for (int arc = graph.ArcBegin(u); arc < graph.ArcEnd(u); arc++) {
+            int v = graph.Neighbor(arc);
+            int next = best[u] + graph.Time(arc);
+            if (!done[v] && (best[v] == kUnreachable || next < best[v]) && !closed_edges.Test(graph.ArcEdge(arc))) {
+                best[v] = next;
+                queue.Push(next + lower_bound(v), v);
+            }
+        }
+    }
+    return kUnreachable;
+}
+
+} // namespace
+
+void LandmarkIndex::Build(const CampusGraph &graph, int count) {
+    int n = graph.LocationCount();
+    landmarks.clear();
+    dist.clear();
+    landmark_count = 0;
+    if (n == 0 || count <= 0) {
+        return;
+    }
+
+    auto all_open = [](int) { return true; };
+    vector<ShortestPathTree> trees;
+    auto search = [&](int source) {
+        trees.emplace_back();
+        if (graph.MaxTime() <= kMaxBucketWeight) {
+            Dijkstra<BucketQueue>(graph, source, -1, all_open, trees.back());
+        } else {
+            Dijkstra<BinaryHeapQueue>(graph, source, -1, all_open, trees.back());
+        }
+    };
+
+    // nearest[v]: distance from v to the closest landmark so far, INT_MAX if
+    // none reaches it; the first landmark is the location farthest from 0
+    search(0);
+    vector<int> nearest(n);
+    for (int v = 0; v < n; v++) {
+        nearest[v] = trees[0].dist[v] == kUnreachable ? INT_MAX : trees[0].dist[v];
+    }
+    trees.clear();
+    while ((int)landmarks.size() < count) {
+        int farthest = (int)(max_element(nearest.begin(), nearest.end()) - nearest.begin());
+        if (nearest[farthest] == 0 && !landmarks.empty()) {
+            break; // every location is a landmark already
+        }
+        landmarks.push_back(farthest);
+        search(farthest);
+        for (int v = 0; v < n; v++) {
+            int d = trees.back().dist[v];
+            if (d != kUnreachable) {
+                nearest[v] = min(nearest[v], d);
+            }
+        }
+    }
+
+    landmark_count = (int)landmarks.size();
+    dist.resize((size_t)n * landmark_count);
+    for (int i = 0; i < landmark_count; i++) {
+        for (int v = 0; v < n; v++) {
+            dist[(size_t)v * landmark_count + i] = trees[i].dist[v];
+        }
+    }
+}
+
+int LandmarkIndex::LowerBound(int v, const int *target_dist) const {
+    const int *v_dist = dist.data() + (size_t)v * landmark_count;
+    int bound = 0;
+    for (int i = 0; i < landmark_count; i++) {
+        // a landmark that cannot reach both says nothing
+        if (v_dist[i] != kUnreachable && target_dist[i] != kUnreachable) {
+            bound = max(bound, abs(target_dist[i] - v_dist[i]));
+        }
+    }
+    return bound;
+}
+
+int LandmarkIndex::Query(const CampusGraph &graph, const Bitset &closed_edges, int source, int target,
+                         int *settled) const {
+    if (settled) {
+        *settled = 0;
+    }
+    const int *target_dist = dist.data() + (size_t)target * landmark_count;
+    auto lower_bound = [this, target_dist](int v) { return LowerBound(v, target_dist); };
+    if (2 * graph.MaxTime() <= kMaxBucketWeight) {
+        return AStar<BucketQueue>(graph, closed_edges, source, target, lower_bound, settled);
+    }
+    return AStar<BinaryHeapQueue>(graph, closed_edges, source, target, lower_bound, settled);
+}
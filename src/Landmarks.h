@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+
+#include "Bitset.h"
+#include "CampusGraph.h"
+
+using namespace std;
+
+// ALT (A*, landmarks, triangle inequality) lower bounds for travel times.
+//
+// edges.csv has no coordinates, so goal direction comes from a few landmark
+// locations with known distances to everything: for any landmark L,
+// |d(L, t) - d(L, v)| <= d(v, t). Landmarks are picked by farthest-point
+// selection, each one as far as possible from those already chosen, which
+// also puts one in every component as long as there are enough of them.
+// Distances are taken with every edge open; closing edges only makes real
+// travel times longer, so the bounds stay admissible (and consistent).
+class LandmarkIndex {
+private:
+    int landmark_count = 0;
+    vector<int> landmarks; // dense indices
+    vector<int> dist;      // [v * landmark_count + i] = d(landmarks[i], v), -1 if unreachable
+
+    // largest lower bound on the travel time from v to target
+    int LowerBound(int v, const int *target_dist) const;
+
+public:
+    // picks up to count landmarks and runs a search from each
+    void Build(const CampusGraph &graph, int count);
+
+    int LandmarkCount() const { return landmark_count; }
+    int Landmark(int i) const { return landmarks[i]; }
+
+    // A* travel time between dense indices source and target over edges not
+    // in closed_edges, -1 if unreachable; settled, if given, receives the
+    // number of locations settled
+    int Query(const CampusGraph &graph, const Bitset &closed_edges, int source, int target,
+              int *settled = nullptr) const;
+};
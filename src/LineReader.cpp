@@ -0,0 +1,41 @@
+#include "LineReader.h"
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+bool LineReader::Next(string_view &line) {
+    size_t end;
+    while ((end = buffer.find('\n', begin)) == string::npos && !at_end) {
+        buffer.erase(0, begin);
+        begin = 0;
+        char chunk[1 << 16];
+#if defined(_WIN32)
+        int count = _read(fd, chunk, sizeof(chunk));
+#else
+        ssize_t count = read(fd, chunk, sizeof(chunk));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+#endif
+        if (count <= 0) {
+            at_end = true; // a read error ends the input like EOF does
+        } else {
+            buffer.append(chunk, (size_t)count);
+        }
+    }
+    if (end == string::npos) {
+        if (begin == buffer.size()) {
+            return false;
+        }
+        end = buffer.size(); // last line without a newline
+    }
+    line = string_view(buffer.data() + begin, end - begin);
+    begin = end < buffer.size() ? end + 1 : end;
+    return true;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// Lines from a descriptor that cannot be mapped (a pipe or a terminal). Input
+// is read in large blocks, but every complete line is handed out as soon as
+// it has arrived, so a caller can act on it while the writer is still
+// producing or waiting. The descriptor is not closed.
+class LineReader {
+private:
+    int fd;
+    string buffer;
+    size_t begin = 0; // start of the first line not handed out yet
+    bool at_end = false;
+
+public:
+    explicit LineReader(int fd) : fd(fd) {
+    }
+
+    // true if Next() can return without reading
+    bool HasLine() const { return at_end || buffer.find('\n', begin) != string::npos; }
+    // next line without its '\n' (the last one may lack it); false once the
+    // input is used up. The view is only good until the next call.
+    bool Next(string_view &line);
+};
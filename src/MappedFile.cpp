@@ -0,0 +1,113 @@
+#include "MappedFile.h"
+
+#include <fcntl.h>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+void MappedFile::Close() {
+#if !defined(_WIN32)
+    if (mapped) {
+        munmap(const_cast<char *>(map_base), map_size);
+    }
+#endif
+    map_base = nullptr;
+    map_size = 0;
+    data = nullptr;
+    size = 0;
+    mapped = false;
+    buffer.clear();
+}
+
+bool MappedFile::Open(const string &path) {
+    Close();
+#if defined(_WIN32)
+    int fd = _open(path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+#endif
+    if (fd < 0) {
+        return false;
+    }
+    bool loaded = Load(fd);
+#if defined(_WIN32)
+    _close(fd);
+#else
+    close(fd);
+#endif
+    return loaded;
+}
+
+bool MappedFile::OpenFd(int fd) {
+    Close();
+    return Load(fd);
+}
+
+bool MappedFile::MapFd(int fd) {
+    Close();
+    return Map(fd);
+}
+
+bool MappedFile::Map(int fd) {
+#if !defined(_WIN32)
+    // regular files are mapped from the descriptor's current position on
+    struct stat info;
+    off_t position = lseek(fd, 0, SEEK_CUR);
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && position >= 0 && info.st_size > position) {
+        void *region = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (region != MAP_FAILED) {
+            madvise(region, (size_t)info.st_size, MADV_SEQUENTIAL);
+            map_base = static_cast<const char *>(region);
+            map_size = (size_t)info.st_size;
+            data = map_base + position;
+            size = map_size - (size_t)position;
+            mapped = true;
+            lseek(fd, 0, SEEK_END); // consumed, as if it had been read
+            return true;
+        }
+    }
+#endif
+    return false;
+}
+
+bool MappedFile::Load(int fd) {
+    if (Map(fd)) {
+        return true;
+    }
+
+    // not mappable (pipe, terminal, empty or exotic file): read it all in large blocks
+    char chunk[1 << 16];
+    while (true) {
+#if defined(_WIN32)
+        int count = _read(fd, chunk, sizeof(chunk));
+#else
+        ssize_t count = read(fd, chunk, sizeof(chunk));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+#endif
+        if (count == 0) {
+            break;
+        }
+        if (count < 0) {
+            buffer.clear();
+            return false;
+        }
+        buffer.append(chunk, (size_t)count);
+    }
+    data = buffer.data();
+    size = buffer.size();
+    return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// Read-only view of a whole file. Regular files are memory-mapped so callers
+// can tokenize straight out of the page cache; anything that cannot be mapped
+// (pipes, character devices, platforms without mmap) is read into an owned
+// buffer in large blocks instead, so View() behaves identically either way.
+class MappedFile {
+private:
+    const char *map_base = nullptr; // whole mapping, when mapped
+    size_t map_size = 0;
+    const char *data = nullptr;     // what View() exposes
+    size_t size = 0;
+    bool mapped = false;
+    string buffer; // fallback storage when the input is not mappable
+
+    void Close();
+    bool Map(int fd);
+    bool Load(int fd);
+
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // returns false if the file cannot be opened or read
+    bool Open(const string &path);
+    // everything left to read on an already open descriptor (e.g. 0 for
+    // stdin); the descriptor is not closed
+    bool OpenFd(int fd);
+    // maps what is left of a regular, non-empty file on an open descriptor;
+    // false without reading anything if it cannot be mapped
+    bool MapFd(int fd);
+
+    string_view View() const { return string_view(data, size); }
+    bool IsMapped() const { return mapped; }
+};
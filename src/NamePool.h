@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "FlatArray.h"
+#include "Snapshot.h"
+
+using namespace std;
+
+// Location names interned into one contiguous character pool and indexed by
+// dense location index. Every name is stored once, however many edges repeat
+// it, and lookups hand out string_views into the pool.
+class NamePool {
+private:
+    FlatArray<char> chars;
+    FlatArray<uint32_t> spans; // name u is chars[spans[2 * u], spans[2 * u + 1])
+
+public:
+    // collects names while edges.csv is being remapped; the first name seen
+    // for a location wins
+    class Builder {
+    private:
+        vector<char> chars;
+        vector<uint32_t> spans;
+        vector<bool> named;
+
+    public:
+        explicit Builder(int location_count)
+            : spans(2 * (size_t)location_count, 0), named(location_count, false) {
+        }
+
+        void Intern(int u, string_view name) {
+            if (named[u]) {
+                return;
+            }
+            named[u] = true;
+            spans[2 * u] = (uint32_t)chars.size();
+            chars.insert(chars.end(), name.begin(), name.end());
+            spans[2 * u + 1] = (uint32_t)chars.size();
+        }
+
+        NamePool Finish() {
+            NamePool pool;
+            pool.chars.Assign(move(chars));
+            pool.spans.Assign(move(spans));
+            return pool;
+        }
+    };
+
+    int size() const { return (int)spans.size() / 2; }
+    string_view operator[](int u) const {
+        return string_view(chars.data() + spans[2 * u], spans[2 * u + 1] - spans[2 * u]);
+    }
+
+    void Save(SnapshotWriter &writer) const {
+        writer.Add(kSectionNameSpans, spans.data(), spans.size());
+        writer.Add(kSectionNameChars, chars.data(), chars.size());
+    }
+
+    // borrows the pool from a snapshot; false if it is missing or does not
+    // describe exactly location_count names (spans are only checked against
+    // the characters on a verified load)
+    bool Load(const SnapshotReader &reader, size_t location_count) {
+        const uint32_t *span_items = nullptr;
+        const char *char_items = nullptr;
+        size_t span_count = 0, char_count = 0;
+        if (!reader.Get(kSectionNameSpans, span_items, span_count) ||
+            !reader.Get(kSectionNameChars, char_items, char_count) || span_count != 2 * location_count) {
+            return false;
+        }
+        for (size_t i = 0; reader.Verified() && i < span_count; i += 2) {
+            if (span_items[i] > span_items[i + 1] || span_items[i + 1] > char_count) {
+                return false;
+            }
+        }
+        spans.Borrow(span_items, span_count);
+        chars.Borrow(char_items, char_count);
+        return true;
+    }
+};
@@ -0,0 +1,53 @@
+#include "OutputSink.h"
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+const size_t kFdSinkBufferBytes = 1 << 16;
+
+bool IsTerminal(int fd) {
+#if defined(_WIN32)
+    return _isatty(fd) != 0;
+#else
+    return isatty(fd) != 0;
+#endif
+}
+
+} // namespace
+
+FdSink::FdSink(int fd) : OutputSink(IsTerminal(fd) ? 1 : kFdSinkBufferBytes), fd(fd) {
+    buffer.reserve(kFdSinkBufferBytes + 256);
+}
+
+FdSink::~FdSink() {
+    Flush();
+}
+
+void FdSink::Drain() {
+    const char *data = buffer.data();
+    size_t remaining = buffer.size();
+    while (remaining > 0) {
+#if defined(_WIN32)
+        int written = _write(fd, data, (unsigned int)remaining);
+#else
+        ssize_t written = write(fd, data, remaining);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+#endif
+        if (written <= 0) {
+            break; // nowhere to report it; drop the output like a closed stdout would
+        }
+        data += written;
+        remaining -= (size_t)written;
+    }
+    buffer.clear();
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// Append buffer that command results are written to. Appends only copy into
+// the buffer; once it holds flush_threshold bytes (or on Flush()) the whole
+// buffer is handed to Drain() in one piece.
+class OutputSink {
+protected:
+    string buffer;
+    size_t flush_threshold;
+
+    // consumes the buffered bytes (e.g. writes them out) and clears the buffer
+    virtual void Drain() = 0;
+
+public:
+    explicit OutputSink(size_t flush_threshold) : flush_threshold(flush_threshold) {
+    }
+    virtual ~OutputSink() = default;
+    OutputSink(const OutputSink &) = delete;
+    OutputSink &operator=(const OutputSink &) = delete;
+
+    OutputSink &operator<<(string_view text) {
+        buffer.append(text);
+        if (buffer.size() >= flush_threshold) {
+            Drain();
+        }
+        return *this;
+    }
+    OutputSink &operator<<(const char *text) { return *this << string_view(text); }
+    OutputSink &operator<<(const string &text) { return *this << string_view(text); }
+    OutputSink &operator<<(char c) { return *this << string_view(&c, 1); }
+    OutputSink &operator<<(int value) {
+        char digits[16];
+        char *end = to_chars(digits, digits + sizeof(digits), value).ptr;
+        return *this << string_view(digits, end - digits);
+    }
+
+    void Flush() {
+        if (!buffer.empty()) {
+            Drain();
+        }
+    }
+};
+
+// Keeps everything in memory; used by tests and by callers that want the
+// results of a batch as one string.
+class StringSink : public OutputSink {
+protected:
+    void Drain() override {
+    }
+
+public:
+    StringSink() : OutputSink(string::npos) {
+    }
+
+    const string &str() const { return buffer; }
+    void clear() { buffer.clear(); }
+};
+
+// Buffers output for a file descriptor and writes it with one write(2) per
+// 64 KiB (per append when the descriptor is a terminal, so interactive use
+// still sees each result immediately). Flushes on destruction.
+class FdSink : public OutputSink {
+private:
+    int fd;
+
+protected:
+    void Drain() override;
+
+public:
+    explicit FdSink(int fd);
+    ~FdSink() override;
+};
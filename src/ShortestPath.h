@@ -0,0 +1,324 @@
+#pragma once
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "CampusGraph.h"
+
+using namespace std;
+
+// distance of a location that cannot be reached
+const int kUnreachable = -1;
+
+// Priority queue policies for Dijkstra. Both allow stale entries (lazy
+// deletion): Dijkstra skips anything popped after its node was settled.
+// Each is constructed with the largest arc weight in the graph.
+
+// std::priority_queue min-heap; works for any weights
+class BinaryHeapQueue {
+private:
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> heap;
+
+public:
+    explicit BinaryHeapQueue(int /*max_weight*/) {
+    }
+
+    void Push(int dist, int node) { heap.emplace(dist, node); }
+    bool Empty() const { return heap.empty(); }
+    pair<int, int> Pop() {
+        pair<int, int> top = heap.top();
+        heap.pop();
+        return top;
+    }
+};
+
+// Dial's monotone bucket queue: max_weight + 1 circular buckets indexed by
+// distance. Since Dijkstra never pushes more than max_weight past the
+// distance being settled, every pending entry is in a distinct bucket
+// position and popping is a scan forward from the last popped distance.
+class BucketQueue {
+private:
+    vector<vector<int>> buckets;
+    int current = 0; // distance of the bucket being drained
+    int size = 0;
+    bool started = false;
+
+public:
+    explicit BucketQueue(int max_weight) : buckets(max_weight + 1) {
+    }
+
+    void Push(int dist, int node) {
+        if (!started) {
+            current = dist; // the first key may be anywhere
+            started = true;
+        }
+        buckets[dist % buckets.size()].push_back(node);
+        size++;
+    }
+    bool Empty() const { return size == 0; }
+    pair<int, int> Pop() {
+        while (buckets[current % buckets.size()].empty()) {
+            current++;
+        }
+        vector<int> &bucket = buckets[current % buckets.size()];
+        int node = bucket.back();
+        bucket.pop_back();
+        size--;
+        return {current, node};
+    }
+};
+
+// result of a single-source search
+struct ShortestPathTree {
+    vector<int> dist;         // travel time to each location, kUnreachable if none
+    vector<int> parents;      // predecessor on the shortest path, -1 at the root and unreached
+    vector<int> parent_edges; // edge ID joining each location to its parent, -1 if none
+};
+
+// Dial's algorithm only pays off while the bucket ring is small
+const int kMaxBucketWeight = 1 << 12;
+
+// Dijkstra over the edges of graph accepted by is_open(edge ID), from the
+// dense index source, into tree. With target != -1 the search stops once
+// target is settled; only locations settled by then have final values.
+template <typename Queue, typename EdgeFilter>
+void Dijkstra(const CampusGraph &graph, int source, int target, const EdgeFilter &is_open, ShortestPathTree &tree) {
+    int n = graph.LocationCount();
+    tree.dist.assign(n, kUnreachable);
+    tree.parents.assign(n, -1);
+    tree.parent_edges.assign(n, -1);
+    vector<int> best(n, kUnreachable); // tentative distances
+    vector<bool> settled(n, false);
+    Queue queue(graph.MaxTime());
+    best[source] = 0;
+    queue.Push(0, source);
+    while (!queue.Empty()) {
+        auto [time, u] = queue.Pop();
+        if (settled[u]) {
+            continue;
+        }
+        settled[u] = true;
+        tree.dist[u] = time;
+        if (u == target) {
+            return;
+        }
+        for (int arc = graph.ArcBegin(u); arc < graph.ArcEnd(u); arc++) {
+            int v = graph.Neighbor(arc);
+            int next = time + graph.Time(arc);
+            if (!settled[v] && (best[v] == kUnreachable || next < best[v]) && is_open(graph.ArcEdge(arc))) {
+                best[v] = next;
+                tree.parents[v] = u;
+                tree.parent_edges[v] = graph.ArcEdge(arc);
+                queue.Push(next, v);
+            }
+        }
+    }
+}
+
+// Dynamic single-source shortest paths in the style of Ramalingam and Reps:
+// after edges change state, only the part of a complete tree whose distances
+// change is searched again. Repairs seed the queue with arbitrary distances,
+// so they always use the binary heap (the bucket ring assumes every entry is
+// within the largest edge time of the last one popped).
+
+// Repairs tree after the edges in closed stopped being accepted by is_open;
+// tree must have been exact before. Only the subtrees hanging off closed tree
+// edges lose their distances, and they are re-settled from their unaffected
+// neighbors.
+template <typename EdgeFilter>
+void RepairAfterClosures(const CampusGraph &graph, ShortestPathTree &tree, const vector<int> &closed,
+                         const EdgeFilter &is_open) {
+    int n = graph.LocationCount();
+    vector<int> roots;
+    for (int edge : closed) {
+        for (int end : {graph.EdgeSource(edge), graph.EdgeTarget(edge)}) {
+            if (tree.parent_edges[end] == edge) {
+                roots.push_back(end);
+            }
+        }
+    }
+    if (roots.empty()) {
+        return;
+    }
+
+    // children of every location, as a counting sort of the parent array
+    vector<int> child_offsets(n + 1, 0);
+    for (int v = 0; v < n; v++) {
+        if (tree.parents[v] != -1) {
+            child_offsets[tree.parents[v] + 1]++;
+        }
+    }
+    for (int u = 0; u < n; u++) {
+        child_offsets[u + 1] += child_offsets[u];
+    }
+    vector<int> children(child_offsets[n]);
+    vector<int> cursor(child_offsets.begin(), child_offsets.end() - 1);
+    for (int v = 0; v < n; v++) {
+        if (tree.parents[v] != -1) {
+            children[cursor[tree.parents[v]]++] = v;
+        }
+    }
+
+    // everything below a closed tree edge is affected
+    vector<bool> affected(n, false);
+    vector<int> stack = roots, region;
+    while (!stack.empty()) {
+        int u = stack.back();
+        stack.pop_back();
+        if (affected[u]) {
+            continue;
+        }
+        affected[u] = true;
+        region.push_back(u);
+        for (int i = child_offsets[u]; i < child_offsets[u + 1]; i++) {
+            stack.push_back(children[i]);
+        }
+    }
+    for (int u : region) {
+        tree.dist[u] = kUnreachable;
+        tree.parents[u] = -1;
+        tree.parent_edges[u] = -1;
+    }
+
+    // best way into the region from outside, then Dijkstra inside it
+    BinaryHeapQueue queue(graph.MaxTime());
+    vector<int> best(n, kUnreachable);
+    for (int u : region) {
+        for (int arc = graph.ArcBegin(u); arc < graph.ArcEnd(u); arc++) {
+            int w = graph.Neighbor(arc);
+            if (affected[w] || tree.dist[w] == kUnreachable || !is_open(graph.ArcEdge(arc))) {
+                continue;
+            }
+            int next = tree.dist[w] + graph.Time(arc);
+            if (best[u] == kUnreachable || next < best[u]) {
+                best[u] = next;
+                tree.parents[u] = w;
+                tree.parent_edges[u] = graph.ArcEdge(arc);
+            }
+        }
+        if (best[u] != kUnreachable) {
+            queue.Push(best[u], u);
+        }
+    }
+    while (!queue.Empty()) {
+        auto [time, u] = queue.Pop();
+        if (tree.dist[u] != kUnreachable) {
+            continue;
+        }
+        tree.dist[u] = time;
+        for (int arc = graph.ArcBegin(u); arc < graph.ArcEnd(u); arc++) {
+            int v = graph.Neighbor(arc);
+            int next = time + graph.Time(arc);
+            if (affected[v] && tree.dist[v] == kUnreachable && (best[v] == kUnreachable || next < best[v]) &&
+                is_open(graph.ArcEdge(arc))) {
+                best[v] = next;
+                tree.parents[v] = u;
+                tree.parent_edges[v] = graph.ArcEdge(arc);
+                queue.Push(next, v);
+            }
+        }
+    }
+}
+
+// Repairs tree after the edges in opened started being accepted by is_open;
+// tree must have been exact without them. Distances can only drop, so only
+// locations that get closer through an opened edge are searched again.
+template <typename EdgeFilter>
+void RepairAfterOpenings(const CampusGraph &graph, ShortestPathTree &tree, const vector<int> &opened,
+                         const EdgeFilter &is_open) {
+    BinaryHeapQueue queue(graph.MaxTime());
+    auto improve = [&](int u, int v, int edge, int next) {
+        if (tree.dist[v] == kUnreachable || next < tree.dist[v]) {
+            tree.dist[v] = next;
+            tree.parents[v] = u;
+            tree.parent_edges[v] = edge;
+            queue.Push(next, v);
+        }
+    };
+    for (int edge : opened) {
+        int a = graph.EdgeSource(edge);
+        for (int arc = graph.ArcBegin(a); arc < graph.ArcEnd(a); arc++) {
+            if (graph.ArcEdge(arc) != edge) {
+                continue;
+            }
+            int b = graph.Neighbor(arc);
+            if (tree.dist[a] != kUnreachable) {
+                improve(a, b, edge, tree.dist[a] + graph.Time(arc));
+            }
+            if (tree.dist[b] != kUnreachable) {
+                improve(b, a, edge, tree.dist[b] + graph.Time(arc));
+            }
+            break;
+        }
+    }
+    while (!queue.Empty()) {
+        auto [time, u] = queue.Pop();
+        if (time != tree.dist[u]) {
+            continue; // improved again since this entry was pushed
+        }
+        for (int arc = graph.ArcBegin(u); arc < graph.ArcEnd(u); arc++) {
+            if (is_open(graph.ArcEdge(arc))) {
+                improve(u, graph.Neighbor(arc), graph.ArcEdge(arc), time + graph.Time(arc));
+            }
+        }
+    }
+}
+
+// Point-to-point travel time from source to target over the edges accepted by
+// is_open, or kUnreachable. Searches forward from source and backward from
+// target at the same time and stops once no path through the unsettled part
+// of either side can beat the best meeting point found so far. settled, if
+// given, receives the number of locations settled by the two searches.
+template <typename Queue, typename EdgeFilter>
+int BidirectionalDijkstra(const CampusGraph &graph, int source, int target, const EdgeFilter &is_open,
+                          int *settled = nullptr) {
+    if (settled) {
+        *settled = 0;
+    }
+    if (source == target) {
+        return 0;
+    }
+    int n = graph.LocationCount();
+    vector<int> best[2] = {vector<int>(n, kUnreachable), vector<int>(n, kUnreachable)};
+    vector<bool> done[2] = {vector<bool>(n, false), vector<bool>(n, false)};
+    Queue queues[2] = {Queue(graph.MaxTime()), Queue(graph.MaxTime())};
+    int last[2] = {0, 0}; // last distance settled on each side
+    int shortest = kUnreachable;
+    best[0][source] = 0;
+    best[1][target] = 0;
+    queues[0].Push(0, source);
+    queues[1].Push(0, target);
+
+    for (int side = 0; !queues[0].Empty() && !queues[1].Empty(); side ^= 1) {
+        auto [time, u] = queues[side].Pop();
+        if (done[side][u]) {
+            continue;
+        }
+        // last[other] is a lower bound on the other side's queue
+        if (shortest != kUnreachable && time + last[side ^ 1] >= shortest) {
+            break;
+        }
+        done[side][u] = true;
+        last[side] = time;
+        if (settled) {
+            (*settled)++;
+        }
+        for (int arc = graph.ArcBegin(u); arc < graph.ArcEnd(u); arc++) {
+            if (!is_open(graph.ArcEdge(arc))) {
+                continue;
+            }
+            int v = graph.Neighbor(arc);
+            int next = time + graph.Time(arc);
+            if (!done[side][v] && (best[side][v] == kUnreachable || next < best[side][v])) {
+                best[side][v] = next;
+                queues[side].Push(next, v);
+            }
+            int other = best[side ^ 1][v];
+            if (other != kUnreachable && (shortest == kUnreachable || next + other < shortest)) {
+                shortest = next + other;
+            }
+        }
+    }
+    return shortest;
+}
@@ -0,0 +1,144 @@
+#include "Snapshot.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+
+namespace {
+
+const char kMagic[8] = {'C', 'C', 'S', 'N', 'A', 'P', '\0', '\0'};
+const uint32_t kByteOrderMark = 0x01020304;
+
+size_t AlignUp(size_t offset) {
+    return (offset + 7) & ~size_t(7);
+}
+
+} // namespace
+
+uint64_t Fnv1a(const char *bytes, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= (unsigned char)bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t PayloadHash(const char *bytes, size_t size) {
+    const uint64_t prime = 1099511628211ULL;
+    uint64_t lanes[4] = {14695981039346656037ULL, 0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL,
+                         0x165667B19E3779F9ULL};
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int lane = 0; lane < 4; lane++) {
+            uint64_t word;
+            memcpy(&word, bytes + i + 8 * lane, 8);
+            lanes[lane] = (lanes[lane] ^ word) * prime;
+            lanes[lane] ^= lanes[lane] >> 29;
+        }
+    }
+    uint64_t hash = Fnv1a(bytes + i, size - i);
+    for (uint64_t lane : lanes) {
+        hash = (hash ^ lane) * prime;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+bool SnapshotWriter::WriteTo(const string &path) const {
+    size_t offset = AlignUp(sizeof(SnapshotHeader) + sections.size() * sizeof(SnapshotSection));
+    vector<SnapshotSection> table;
+    for (const PendingSection &section : sections) {
+        table.push_back({section.id, section.element_size, offset, section.bytes.size() / section.element_size});
+        offset = AlignUp(offset + section.bytes.size());
+    }
+
+    vector<char> image(offset, 0);
+    memcpy(image.data() + sizeof(SnapshotHeader), table.data(), table.size() * sizeof(SnapshotSection));
+    for (size_t i = 0; i < sections.size(); i++) {
+        if (!sections[i].bytes.empty()) {
+            memcpy(image.data() + table[i].offset, sections[i].bytes.data(), sections[i].bytes.size());
+        }
+    }
+
+    SnapshotHeader header;
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kSnapshotVersion;
+    header.byte_order = kByteOrderMark;
+    header.section_count = sections.size();
+    header.payload_size = image.size() - sizeof(SnapshotHeader);
+    header.table_checksum = Fnv1a(image.data() + sizeof(SnapshotHeader), table.size() * sizeof(SnapshotSection));
+    header.payload_checksum = PayloadHash(image.data() + sizeof(SnapshotHeader), header.payload_size);
+    memcpy(image.data(), &header, sizeof(header));
+
+    // Readers map the file in place, so it is never rewritten: the image
+    // goes to a temporary file that is renamed over the old snapshot. A
+    // process that already has the old one mapped keeps a complete copy.
+    string temporary = path + ".tmp";
+    ofstream file(temporary, ios::binary | ios::trunc);
+    file.write(image.data(), (streamsize)image.size());
+    file.close();
+    if (!file) {
+        remove(temporary.c_str());
+        return false;
+    }
+#if defined(_WIN32)
+    remove(path.c_str()); // rename does not replace an existing file there
+#endif
+    if (rename(temporary.c_str(), path.c_str()) != 0) {
+        remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool SnapshotReader::Open(const string &path, bool verify_payload) {
+    file = make_shared<MappedFile>();
+    sections = nullptr;
+    section_count = 0;
+    verified = false;
+    if (!file->Open(path)) {
+        return false;
+    }
+
+    string_view bytes = file->View();
+    SnapshotHeader header;
+    if (bytes.size() < sizeof(header) || reinterpret_cast<uintptr_t>(bytes.data()) % 8 != 0) {
+        return false;
+    }
+    memcpy(&header, bytes.data(), sizeof(header));
+    if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kSnapshotVersion ||
+        header.byte_order != kByteOrderMark || header.payload_size != bytes.size() - sizeof(header) ||
+        header.section_count > header.payload_size / sizeof(SnapshotSection) ||
+        header.table_checksum != Fnv1a(bytes.data() + sizeof(header), header.section_count * sizeof(SnapshotSection))) {
+        return false;
+    }
+    if (verify_payload && header.payload_checksum != PayloadHash(bytes.data() + sizeof(header), header.payload_size)) {
+        return false;
+    }
+
+    sections = reinterpret_cast<const SnapshotSection *>(bytes.data() + sizeof(header));
+    section_count = (size_t)header.section_count;
+    for (size_t i = 0; i < section_count; i++) {
+        const SnapshotSection &section = sections[i];
+        if (section.element_size == 0 || section.offset % 8 != 0 || section.offset > bytes.size() ||
+            section.count > (bytes.size() - section.offset) / section.element_size) {
+            sections = nullptr;
+            section_count = 0;
+            return false;
+        }
+    }
+    verified = verify_payload;
+    return true;
+}
+
+const SnapshotSection *SnapshotReader::Find(uint32_t id, uint32_t element_size) const {
+    for (size_t i = 0; i < section_count; i++) {
+        if (sections[i].id == id) {
+            return sections[i].element_size == element_size ? &sections[i] : nullptr;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+using namespace std;
+
+// Binary snapshot of the parsed campus data.
+//
+// Layout: a fixed SnapshotHeader, then section_count SnapshotSection entries,
+// then the section payloads, each 8-byte aligned. Integers are stored in the
+// writer's native byte order; the header records it so a mismatched reader
+// rejects the file instead of misreading it. Because payloads are aligned raw
+// arrays, a reader can point straight into the mapped file.
+//
+// Opening a snapshot only checks the header and the section table (64-bit
+// FNV-1a), so a load costs microseconds and touches no payload page; the
+// payload is trusted as SaveSnapshot wrote it (snapshots are replaced by
+// rename, never rewritten in place). A verifying open also hashes the whole
+// payload, and loaders then range-check every value, for files that may be
+// damaged or come from elsewhere.
+const uint32_t kSnapshotVersion = 5;
+
+enum SnapshotSectionId : uint32_t {
+    kSectionLocationIds = 1,
+    kSectionOffsets,
+    kSectionNeighbors,
+    kSectionTimes,
+    kSectionArcEdges,
+    kSectionEdgeEndpoints,
+    kSectionNameSpans,
+    kSectionNameChars,
+    kSectionClasses,
+    kSectionEdgeTable,
+    kSectionMaxTime,
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order; // 0x01020304 as written by the producer
+    uint64_t section_count;
+    uint64_t payload_size; // bytes after the header
+    uint64_t table_checksum;   // FNV-1a of the section table
+    uint64_t payload_checksum; // PayloadHash of everything after the header
+};
+
+struct SnapshotSection {
+    uint32_t id;
+    uint32_t element_size;
+    uint64_t offset; // from the start of the file
+    uint64_t count;  // number of elements
+};
+
+// accumulates sections in memory and writes them out in one go
+class SnapshotWriter {
+private:
+    struct PendingSection {
+        uint32_t id;
+        uint32_t element_size;
+        vector<char> bytes;
+    };
+    vector<PendingSection> sections;
+
+public:
+    template <typename T>
+    void Add(uint32_t id, const T *items, size_t count) {
+        const char *bytes = reinterpret_cast<const char *>(items);
+        sections.push_back({id, (uint32_t)sizeof(T), vector<char>(bytes, bytes + count * sizeof(T))});
+    }
+
+    // writes path + ".tmp" and renames it over path, so processes that have
+    // the old snapshot mapped or are opening it never see a partial file
+    bool WriteTo(const string &path) const;
+};
+
+// maps a snapshot and hands out typed views of its sections
+class SnapshotReader {
+private:
+    shared_ptr<MappedFile> file;
+    const SnapshotSection *sections = nullptr;
+    size_t section_count = 0;
+    bool verified = false;
+
+    const SnapshotSection *Find(uint32_t id, uint32_t element_size) const;
+
+public:
+    // false if the file is missing, truncated, from another version, or its
+    // header or section table is corrupt; with verify_payload also if any
+    // payload byte is
+    bool Open(const string &path, bool verify_payload = false);
+    // whether Open hashed the payload, so loaders should range-check values too
+    bool Verified() const { return verified; }
+
+    // points items at the section's elements inside the mapped file; on false
+    // items is nullptr and count 0
+    template <typename T>
+    bool Get(uint32_t id, const T *&items, size_t &count) const {
+        const SnapshotSection *section = Find(id, (uint32_t)sizeof(T));
+        if (!section) {
+            items = nullptr;
+            count = 0;
+            return false;
+        }
+        items = reinterpret_cast<const T *>(file->View().data() + section->offset);
+        count = (size_t)section->count;
+        return true;
+    }
+
+    // the mapping the views point into; hold on to it for as long as they are used
+    shared_ptr<MappedFile> File() const { return file; }
+};
+
+uint64_t Fnv1a(const char *bytes, size_t size);
+// hash of a payload, eight bytes at a time in four independent lanes, so
+// verifying a large snapshot runs near memory speed
+uint64_t PayloadHash(const char *bytes, size_t size);
@@ -0,0 +1,160 @@
+#include "StudentTable.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+// compaction waits for at least this much dead space, so small registries
+// never bother
+const size_t kMinDeadNameBytes = 4096;
+
+} // namespace
+
+size_t StudentTable::Home(int ufid) const {
+    return (size_t)(((uint64_t)(uint32_t)ufid * 0x9E3779B97F4A7C15ULL) >> 32) & (index.size() - 1);
+}
+
+void StudentTable::Grow() {
+    vector<IndexEntry> old = move(index);
+    index.assign(old.empty() ? 16 : old.size() * 2, IndexEntry{0, -1});
+    size_t mask = index.size() - 1;
+    for (const IndexEntry &entry : old) {
+        if (entry.slot != -1) {
+            size_t i = Home(entry.ufid);
+            while (index[i].slot != -1) {
+                i = (i + 1) & mask;
+            }
+            index[i] = entry;
+        }
+    }
+}
+
+int StudentTable::Find(int ufid) const {
+    if (index.empty()) {
+        return -1;
+    }
+    size_t mask = index.size() - 1;
+    for (size_t i = Home(ufid); index[i].slot != -1; i = (i + 1) & mask) {
+        if (index[i].ufid == ufid) {
+            return index[i].slot;
+        }
+    }
+    return -1;
+}
+
+Student *StudentTable::Get(int ufid) {
+    int slot = Find(ufid);
+    return slot < 0 ? nullptr : &records[slot];
+}
+
+const Student *StudentTable::Get(int ufid) const {
+    int slot = Find(ufid);
+    return slot < 0 ? nullptr : &records[slot];
+}
+
+int StudentTable::Insert(int ufid, int residence_id, string_view name) {
+    if (Find(ufid) >= 0) {
+        return -1;
+    }
+    if (2 * ((size_t)count + 1) > index.size()) {
+        Grow();
+    }
+    Student student{ufid, residence_id, (uint32_t)names.size(), (uint32_t)name.size(), {}, {}};
+    names.insert(names.end(), name.begin(), name.end());
+    int slot;
+    if (free_slots.empty()) {
+        slot = (int)records.size();
+        records.push_back(student);
+    } else {
+        slot = free_slots.back();
+        free_slots.pop_back();
+        records[slot] = student;
+    }
+    size_t mask = index.size() - 1;
+    size_t i = Home(ufid);
+    while (index[i].slot != -1) {
+        i = (i + 1) & mask;
+    }
+    index[i] = IndexEntry{ufid, slot};
+    count++;
+    WriteRow(slot);
+    return slot;
+}
+
+bool StudentTable::Erase(int ufid) {
+    if (index.empty()) {
+        return false;
+    }
+    size_t mask = index.size() - 1;
+    size_t hole = Home(ufid);
+    while (index[hole].slot != -1 && index[hole].ufid != ufid) {
+        hole = (hole + 1) & mask;
+    }
+    if (index[hole].slot == -1) {
+        return false;
+    }
+    int slot = index[hole].slot;
+    dead_name_bytes += records[slot].name_length;
+    records[slot] = Student{-1, 0, 0, 0, {}, {}};
+    WriteRow(slot);
+    free_slots.push_back(slot);
+    count--;
+    if (dead_name_bytes >= kMinDeadNameBytes && 2 * dead_name_bytes > names.size()) {
+        CompactNames();
+    }
+
+    // backward shift: move up every later entry of the run whose home is not
+    // between the hole and its current position
+    for (size_t next = (hole + 1) & mask; index[next].slot != -1; next = (next + 1) & mask) {
+        size_t home = Home(index[next].ufid);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            index[hole] = index[next];
+            hole = next;
+        }
+    }
+    index[hole].slot = -1;
+    return true;
+}
+
+void StudentTable::CompactNames() {
+    vector<char> live;
+    live.reserve(names.size() - dead_name_bytes);
+    for (Student &student : records) {
+        if (student.ufid != -1) {
+            const char *name = names.data() + student.name_offset;
+            student.name_offset = (uint32_t)live.size();
+            live.insert(live.end(), name, name + student.name_length);
+        }
+    }
+    names = move(live);
+    dead_name_bytes = 0;
+}
+
+void StudentTable::WriteRow(int slot) {
+    if ((size_t)slot == columns.ufids.size()) {
+        columns.ufids.push_back(-1);
+        columns.residence_ids.push_back(0);
+        columns.class_counts.push_back(0);
+        columns.class_keys.resize(columns.class_keys.size() + kMaxClasses, 0);
+    }
+    const Student &student = records[slot];
+    columns.ufids[slot] = student.ufid;
+    columns.residence_ids[slot] = student.residence_id;
+    columns.class_counts[slot] = (uint8_t)student.classes.size();
+    ClassKey *keys = columns.class_keys.data() + (size_t)slot * kMaxClasses;
+    fill(copy(student.classes.begin(), student.classes.end(), keys), keys + kMaxClasses, 0);
+}
+
+void StudentTable::Clear() {
+    records.clear();
+    free_slots.clear();
+    index.clear();
+    count = 0;
+    names.clear();
+    dead_name_bytes = 0;
+    columns = StudentColumns();
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "ClassCatalog.h"
+#include "InlineVector.h"
+
+using namespace std;
+
+struct Student {
+    int ufid;
+    int residence_id;
+    uint32_t name_offset; // the name lives in the table's arena, see StudentTable::Name()
+    uint32_t name_length;
+    InlineVector<ClassKey, kMaxClasses> classes; // kept sorted, which is also class code order
+    // index of this student in the roster of classes[i], -1 if the class is
+    // not in the catalog
+    InlineVector<int32_t, kMaxClasses> roster_positions;
+};
+
+// The fields of a StudentTable that reports scan, one array per field, so a
+// report that visits every student streams only the fields it reads. Row r
+// is slot r of the table; rows of free slots have ufid -1 and no classes.
+// The table keeps the columns current on every change, at about 33 bytes
+// per slot next to the records.
+struct StudentColumns {
+    vector<int32_t> ufids;
+    vector<int32_t> residence_ids;
+    vector<uint8_t> class_counts;
+    vector<ClassKey> class_keys; // kMaxClasses per row in sorted order, unused entries 0
+
+    int size() const { return (int)ufids.size(); }
+    const ClassKey *ClassesOf(int row) const { return class_keys.data() + (size_t)row * kMaxClasses; }
+};
+
+// Students by UFID. Records live in one vector and are addressed by slot;
+// slots of removed students are reused. The UFID -> slot index is a flat
+// open-addressing table with linear probing, kept at most half full, and
+// removals shift later entries of the probe run back instead of leaving
+// tombstones, so lookups never get slower as students come and go.
+// Names are appended to one character arena; the space of removed names is
+// reclaimed by compacting the arena once most of it is dead.
+class StudentTable {
+private:
+    struct IndexEntry {
+        int ufid;
+        int slot; // -1 while the entry is empty
+    };
+
+    vector<Student> records;  // slot -> student; ufid is -1 for a free slot
+    vector<int> free_slots;
+    vector<IndexEntry> index; // power-of-two size, or empty
+    int count = 0;
+    vector<char> names;
+    size_t dead_name_bytes = 0; // bytes of names of removed students
+    StudentColumns columns;
+
+    size_t Home(int ufid) const;
+    void Grow();
+    // copies the names of current students to a fresh arena
+    void CompactNames();
+    // copies records[slot] into row slot of the columns
+    void WriteRow(int slot);
+
+public:
+    // slot of the student, -1 if there is none
+    int Find(int ufid) const;
+    // nullptr if there is no such student
+    Student *Get(int ufid);
+    const Student *Get(int ufid) const;
+
+    // slot of a new student with no classes, -1 if the UFID is taken
+    int Insert(int ufid, int residence_id, string_view name);
+    // false if there is no such student
+    bool Erase(int ufid);
+    void Clear();
+
+    int size() const { return count; }
+    // slots run from 0 to SlotCount() - 1; a slot is in use if IsUsed(slot)
+    int SlotCount() const { return (int)records.size(); }
+    bool IsUsed(int slot) const { return records[slot].ufid != -1; }
+    Student &At(int slot) { return records[slot]; }
+    const Student &At(int slot) const { return records[slot]; }
+    // call after changing At(slot).classes, to update the columns
+    void ClassesChanged(int slot) { WriteRow(slot); }
+    const StudentColumns &Columns() const { return columns; }
+    // valid until the next Insert or Erase
+    string_view Name(const Student &student) const {
+        return string_view(names.data() + student.name_offset, student.name_length);
+    }
+};
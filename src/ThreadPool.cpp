@@ -0,0 +1,101 @@
+#include "ThreadPool.h"
+
+using namespace std;
+
+namespace {
+
+// which pool and deque the current thread works for, if any
+thread_local const void *current_pool = nullptr;
+thread_local int current_index = -1;
+
+} // namespace
+
+ThreadPool::ThreadPool(int thread_count) {
+    if (thread_count < 1) {
+        thread_count = 1;
+    }
+    for (int i = 0; i < thread_count; i++) {
+        queues.push_back(make_unique<TaskQueue>());
+    }
+    for (int i = 0; i < thread_count; i++) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    task_ready.notify_all();
+    for (thread &worker : workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::DefaultThreadCount() {
+    int count = (int)thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+void ThreadPool::Submit(function<void()> task) {
+    size_t index = current_pool == this ? (size_t)current_index : next_queue++ % queues.size();
+    {
+        // counted before it can be taken, so Wait() never sees it finish first
+        lock_guard<mutex> guard(lock);
+        unfinished++;
+        queued++;
+    }
+    {
+        lock_guard<mutex> guard(queues[index]->lock);
+        queues[index]->tasks.push_back(move(task));
+    }
+    task_ready.notify_one();
+}
+
+void ThreadPool::Wait() {
+    unique_lock<mutex> guard(lock);
+    all_done.wait(guard, [this] { return unfinished == 0; });
+}
+
+bool ThreadPool::TakeTask(int index, function<void()> &task) {
+    int count = (int)queues.size();
+    for (int offset = 0; offset < count; offset++) {
+        TaskQueue &queue = *queues[(index + offset) % count];
+        lock_guard<mutex> guard(queue.lock);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        if (offset == 0) {
+            task = move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        queued--;
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::WorkerLoop(int index) {
+    current_pool = this;
+    current_index = index;
+    while (true) {
+        function<void()> task;
+        if (TakeTask(index, task)) {
+            task();
+            lock_guard<mutex> guard(lock);
+            if (--unfinished == 0) {
+                all_done.notify_all();
+            }
+            continue;
+        }
+        unique_lock<mutex> guard(lock);
+        task_ready.wait(guard, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0) {
+            return; // stopping and drained
+        }
+    }
+}
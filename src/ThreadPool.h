@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Fixed-size work-stealing pool. Every worker has its own task deque: it runs
+// its newest task first and, once the deque is empty, steals the oldest task
+// of another worker. Tasks submitted from outside the pool are dealt round
+// robin; tasks submitted by a running task go to that worker's own deque.
+// Submit() tasks, then Wait() for all of them to finish before reading their
+// results.
+class ThreadPool {
+private:
+    struct TaskQueue {
+        deque<function<void()>> tasks;
+        mutex lock;
+    };
+
+    vector<unique_ptr<TaskQueue>> queues; // one per worker
+    vector<thread> workers;
+    mutex lock; // guards unfinished and stopping, and pairs with the condition variables
+    condition_variable task_ready;
+    condition_variable all_done;
+    atomic<int> queued{0};       // tasks sitting in a deque
+    int unfinished = 0;          // queued + running tasks
+    atomic<size_t> next_queue{0}; // round robin for outside submissions
+    bool stopping = false;
+
+    void WorkerLoop(int index);
+    // own newest task, else the oldest task of the next non-empty deque
+    bool TakeTask(int index, function<void()> &task);
+
+public:
+    explicit ThreadPool(int thread_count = DefaultThreadCount());
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    void Submit(function<void()> task);
+    void Wait();
+    int ThreadCount() const { return (int)workers.size(); }
+
+    // one thread per hardware thread, at least one
+    static int DefaultThreadCount();
+};
@@ -1,25 +1,54 @@
-#include <iostream>
-
-#include "CampusCompass.h"
-
-using namespace std;
-
-int main() {
-    // initialize your main project object
-    CampusCompass compass;
-
-    // ingest CSV data
-    compass.ParseCSV("../data/edges.csv", "../data/classes.csv");
-
-    // the below is example code for parsing commandline input
-    int no_of_lines;
-    string command;
-    cin >> no_of_lines;
-    cin.ignore(); // ignore newline that first cin left over
-    for (int i = 0; i < no_of_lines; i++) {
-        getline(cin, command);
-
-        // parse your commands however you see fit
-        compass.ParseCommand(command);
-    }
-}
+#include <iostream>
+#include <string>
+
+#include "CampusCompass.h"
+#include "LineReader.h"
+#include "MappedFile.h"
+
+using namespace std;
+
+int main(int argc, char *argv[]) {
+    // commands come in through MappedFile or LineReader and results go out
+    // through an FdSink, so the iostreams never need to stay in sync with stdio
+    ios::sync_with_stdio(false);
+
+    // initialize your main project object
+    FdSink out(1);
+    CampusCompass compass(out);
+
+    // ingest campus data: `Main --snapshot FILE` starts from a prebuilt
+    // snapshot (`--verify-snapshot FILE` also checks all of it first),
+    // `Main --save-snapshot FILE` parses the CSVs, writes one and exits
+    string option = argc == 3 ? argv[1] : "";
+    if (option == "--snapshot" || option == "--verify-snapshot") {
+        if (!compass.LoadSnapshot(argv[2], option == "--verify-snapshot")) {
+            cerr << "could not load snapshot " << argv[2] << endl;
+            return 1;
+        }
+    } else {
+        bool parsed = compass.ParseCSV("../data/edges.csv", "../data/classes.csv");
+        if (option == "--save-snapshot") {
+            // never replace a good snapshot with an empty campus
+            if (!parsed) {
+                cerr << "could not parse the campus CSVs" << endl;
+                return 1;
+            }
+            if (!compass.SaveSnapshot(argv[2])) {
+                cerr << "could not save snapshot " << argv[2] << endl;
+                return 1;
+            }
+            return 0;
+        }
+    }
+
+    // stdin redirected from a file is mapped and run as one "N, then N
+    // commands" batch; from a pipe or terminal each command runs as soon as
+    // its line arrives, and reading stops after the N-th
+    MappedFile input;
+    if (input.MapFd(0)) {
+        compass.ProcessBatch(input.View(), out);
+    } else {
+        LineReader lines(0);
+        compass.ProcessStream(lines, out);
+    }
+}
@@ -1,42 +1,1099 @@
 #include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <sys/stat.h>
+#include <thread>
+#include <unordered_map>
+#include <unistd.h>
 
 // change if you choose to use a different header name
 #include "CampusCompass.h"
+#include "ClassCatalog.h"
+#include "ContractionHierarchy.h"
+#include "CsvScanner.h"
+#include "DistanceMatrix.h"
+#include "InlineVector.h"
+#include "Landmarks.h"
+#include "LineReader.h"
+#include "MappedFile.h"
+#include "ShortestPath.h"
+#include "Snapshot.h"
+#include "StudentTable.h"
+#include "ThreadPool.h"
 
 using namespace std;
 
+// random multigraph with zero-time edges and times that wrap the bucket ring;
+// time_scale stretches every time (e.g. past what int16 cells can hold)
+CampusGraph RandomGraph(unsigned seed, int locations, int edges, int time_scale = 1) {
+  vector<vector<RawEdge>> chunks(1);
+  auto next = [&seed](unsigned bound) {
+    seed = seed * 1103515245 + 12345;
+    return (int)((seed >> 8) % bound);
+  };
+  for (int i = 0; i < edges; i++) {
+    chunks[0].push_back({next(locations), next(locations), "a", "b", (next(4) == 0 ? 0 : next(30)) * time_scale});
+  }
+  CampusGraph graph;
+  graph.Build(chunks);
+  return graph;
+}
+
+// side x side grid; location r * side + c, edge times between 1 and max_time
+CampusGraph GridGraph(int side, int max_time) {
+  vector<vector<RawEdge>> chunks(1);
+  for (int r = 0; r < side; r++) {
+    for (int c = 0; c < side; c++) {
+      if (c + 1 < side) {
+        chunks[0].push_back({r * side + c, r * side + c + 1, "x", "y", 1 + (r + c) % max_time});
+      }
+      if (r + 1 < side) {
+        chunks[0].push_back({r * side + c, (r + 1) * side + c, "x", "y", 1 + (r * c) % max_time});
+      }
+    }
+  }
+  CampusGraph graph;
+  graph.Build(chunks);
+  return graph;
+}
+
+// class codes of a classes.csv, in file order
+vector<string> CatalogCodes(const string &path) {
+  vector<string> codes;
+  ifstream file(path);
+  string line;
+  getline(file, line); // header
+  while (getline(file, line)) {
+    codes.push_back(line.substr(0, 7));
+  }
+  return codes;
+}
+
 // the syntax for defining a test is below. It is important for the name to be
 // unique, but you can group multiple tests with [tags]. A test can have
 // [multiple][tags] using that syntax.
-TEST_CASE("Example Test Name - Change me!", "[tag]") {
-  // instantiate any class members that you need to test here
-  int one = 1;
+TEST_CASE("ParseCSV builds the campus graph", "[graph]") {
+  CampusCompass c;
+  REQUIRE(c.ParseCSV("data/edges.csv", "data/classes.csv"));
+  REQUIRE_FALSE(c.ParseCSV("data/missing.csv", "data/classes.csv"));
+
+  SECTION("location names") {
+    REQUIRE(c.LocationName(1) == "Hume Hall");
+    REQUIRE(c.LocationName(7) == "Computer Science & Engineering");
+    REQUIRE(c.LocationName(56) == "New Physics Building");
+    REQUIRE(c.LocationName(999).empty());
+  };
+
+  SECTION("edge status") {
+    REQUIRE(c.CheckEdgeStatus(1, 2) == "open");
+    REQUIRE(c.CheckEdgeStatus(2, 1) == "open");
+    REQUIRE(c.CheckEdgeStatus(1, 3) == "DNE");
+    REQUIRE(c.CheckEdgeStatus(1, 999) == "DNE");
+    shared_ptr<const CampusGraph> graph = c.Graph();
+    int edge = graph->FindEdge(1, 2);
+    REQUIRE(edge >= 0);
+    REQUIRE(graph->FindEdge(2, 1) == edge);
+    REQUIRE(graph->LocationId(graph->EdgeSource(edge)) + graph->LocationId(graph->EdgeTarget(edge)) == 3);
+  };
+
+  SECTION("shortest travel times") {
+    REQUIRE(c.TravelTime(1, 1) == 0);
+    REQUIRE(c.TravelTime(1, 4) == 2);
+    REQUIRE(c.TravelTime(1, 5) == 8);  // 1 -> 4 -> 5
+    REQUIRE(c.TravelTime(5, 56) == 12); // 5 -> 7 -> 49 -> 56
+    REQUIRE(c.TravelTime(1, 26) == -1); // 26 and 36 are an island
+    REQUIRE(c.TravelTime(1, 999) == -1);
+  };
+
+  SECTION("closures") {
+    REQUIRE(c.ToggleEdgesClosure({{1, 4}}));
+    REQUIRE(c.CheckEdgeStatus(4, 1) == "closed");
+    REQUIRE(c.TravelTime(1, 4) == 6); // 1 -> 2 -> 4
+    REQUIRE_FALSE(c.ToggleEdgesClosure({{1, 2}, {1, 3}})); // all or nothing
+    REQUIRE(c.CheckEdgeStatus(1, 2) == "open");
+    REQUIRE(c.ToggleEdgesClosure({{52, 33}}));
+    REQUIRE_FALSE(c.IsConnected(33, 52));
+    REQUIRE(c.ToggleEdgesClosure({{1, 4}, {33, 52}}));
+    REQUIRE(c.CheckEdgeStatus(1, 4) == "open");
+    REQUIRE(c.IsConnected(33, 52));
+    REQUIRE(c.IsConnected(1, 56));
+    REQUIRE_FALSE(c.IsConnected(1, 36));
+  };
+}
 
-  // anything that evaluates to false in a REQUIRE block will result in a
-  // failing test
-  REQUIRE(one == 0); // fix me!
+TEST_CASE("MappedFile maps regular files", "[io]") {
+  MappedFile file;
+  REQUIRE(file.Open("data/edges.csv"));
+  REQUIRE(file.IsMapped());
+  REQUIRE(file.View().substr(0, 13) == "LocationID_1,");
+  REQUIRE_FALSE(file.Open("data/missing.csv"));
+  REQUIRE(file.View().empty());
+}
+
+TEST_CASE("MappedFile reads the rest of an open descriptor", "[io]") {
+  FILE *edges = fopen("data/edges.csv", "rb");
+  REQUIRE(edges != nullptr);
+  REQUIRE(fseek(edges, 13, SEEK_SET) == 0); // skip "LocationID_1,"
+  MappedFile file;
+  REQUIRE(file.OpenFd(fileno(edges)));
+  REQUIRE(file.View().substr(0, 13) == "LocationID_2,");
+  fclose(edges);
+}
+
+TEST_CASE("ParseCSV reads pipes the same as mapped files", "[io]") {
+  // FIFOs cannot be mapped, so this goes through the read fallback
+  vector<thread> writers;
+  for (string name : {"edges", "classes"}) {
+    string fifo = name + ".fifo";
+    remove(fifo.c_str());
+    REQUIRE(mkfifo(fifo.c_str(), 0600) == 0);
+    writers.emplace_back([name, fifo] {
+      ifstream source("data/" + name + ".csv", ios::binary);
+      ofstream(fifo, ios::binary) << source.rdbuf();
+    });
+  }
+  StringSink piped_output, mapped_output;
+  CampusCompass piped(piped_output), mapped(mapped_output);
+  bool piped_parsed = piped.ParseCSV("edges.fifo", "classes.fifo");
+  for (thread &writer : writers) {
+    writer.join();
+  }
+  remove("edges.fifo");
+  remove("classes.fifo");
+  REQUIRE(piped_parsed);
+  REQUIRE(mapped.ParseCSV("data/edges.csv", "data/classes.csv"));
+
+  for (int from : {1, 5, 14, 26, 49}) {
+    REQUIRE(piped.LocationName(from) == mapped.LocationName(from));
+    for (int to : {2, 18, 23, 36, 56}) {
+      REQUIRE(piped.TravelTime(from, to) == mapped.TravelTime(from, to));
+    }
+  }
+  REQUIRE(piped.CheckEdgeStatus(45, 47) == mapped.CheckEdgeStatus(45, 47));
+  for (CampusCompass *c : {&piped, &mapped}) {
+    REQUIRE(c->Insert("Student A", 10000001, 1, {"MAC2311", "COP3502", "COP3503"}));
+    REQUIRE(c->PrintShortestEdges(10000001));
+    REQUIRE(c->VerifySchedule(10000001));
+  }
+  REQUIRE(piped_output.str() == mapped_output.str());
+}
+
+TEST_CASE("CsvScanner splits rows across SIMD blocks", "[io]") {
+  // long names push delimiters across several 64-byte blocks; CRLF, blank
+  // lines and a missing trailing newline must all be handled
+  string input = "1,2,Computer Science & Engineering Building Annex North,"
+                 "Marston Science Library Reading Room East Wing,10\r\n"
+                 "\n"
+                 "3,4,a,b,5,extra\n"
+                 "7,8,,,9";
+  CsvScanner scanner(input);
+  string_view fields[5];
+  REQUIRE(scanner.NextRow(fields, 5) == 5);
+  REQUIRE(fields[2] == "Computer Science & Engineering Building Annex North");
+  REQUIRE(fields[3] == "Marston Science Library Reading Room East Wing");
+  REQUIRE(fields[4] == "10");
+  REQUIRE(scanner.NextRow(fields, 5) == 6);
+  REQUIRE(scanner.NextRow(fields, 5) == 5);
+  REQUIRE(fields[0] == "7");
+  REQUIRE(fields[2].empty());
+  REQUIRE(fields[4] == "9");
+  REQUIRE(scanner.NextRow(fields, 5) == 0);
+}
+
+TEST_CASE("Fast field parsers", "[io]") {
+  int value = -1;
+  for (int expected : {0, 7, 42, 999, 1000, 12345, 99999999, 123456789}) {
+    REQUIRE(ParseNumber(to_string(expected), value));
+    REQUIRE(value == expected);
+  }
+  REQUIRE(ParseNumber("00001234", value));
+  REQUIRE(value == 1234);
+  REQUIRE_FALSE(ParseNumber("", value));
+  REQUIRE_FALSE(ParseNumber("1234567890", value));
+  REQUIRE_FALSE(ParseNumber("12a4", value));
+  REQUIRE_FALSE(ParseNumber("1234:", value));
+  REQUIRE_FALSE(ParseNumber("-123", value));
 
-  // all REQUIRE blocks must evaluate to true for the whole test to pass
-  REQUIRE(false); // also fix me!
+  REQUIRE(ParseClock("09:35", value));
+  REQUIRE(value == 575);
+  REQUIRE(ParseClock("23:59", value));
+  REQUIRE(value == 1439);
+  REQUIRE_FALSE(ParseClock("24:00", value));
+  REQUIRE_FALSE(ParseClock("9:35", value));
+  REQUIRE_FALSE(ParseClock("09-35", value));
 }
 
-TEST_CASE("Test 2", "[tag]") {
-  // you can also use "sections" to share setup code between tests, for example:
-  int one = 1;
+TEST_CASE("ParseCSV merges chunks of a large edges.csv", "[io]") {
+  // a ~4MB path graph 1 - 2 - ... - 150001 is split into several chunks
+  const int n = 150000;
+  {
+    ofstream edges("large_edges.csv");
+    edges << "LocationID_1,LocationID_2,Name_1,Name_2,Time\n";
+    for (int i = 1; i <= n; i++) {
+      edges << i << "," << i + 1 << ",Location " << i << ",Location " << i + 1 << ",1\n";
+    }
+  }
+  CampusCompass c;
+  bool parsed = c.ParseCSV("large_edges.csv", "data/classes.csv");
+  remove("large_edges.csv");
+  REQUIRE(parsed);
+  REQUIRE(c.TravelTime(1, n + 1) == n);
+  REQUIRE(c.CheckEdgeStatus(n / 2, n / 2 + 1) == "open");
+  REQUIRE(c.CheckEdgeStatus(n / 2, n / 2 + 2) == "DNE");
+  REQUIRE(c.ToggleEdgesClosure({{n / 3, n / 3 + 1}}));
+  REQUIRE_FALSE(c.IsConnected(1, n + 1));
+}
+
+TEST_CASE("Class codes pack into ordered integer keys", "[classes]") {
+  REQUIRE(EncodeClassCode("COP3502") != 0);
+  REQUIRE(DecodeClassCode(EncodeClassCode("COP3502")) == "COP3502");
+  REQUIRE(DecodeClassCode(EncodeClassCode("AAA0000")) == "AAA0000");
+  REQUIRE(DecodeClassCode(EncodeClassCode("ZZZ9999")) == "ZZZ9999");
+  REQUIRE(EncodeClassCode("CDA3101") < EncodeClassCode("CEN3031"));
+  REQUIRE(EncodeClassCode("COP3502") < EncodeClassCode("COP3503"));
+  REQUIRE(EncodeClassCode("MAC9999") < EncodeClassCode("MAD0000"));
+  REQUIRE(EncodeClassCode("cop3502") == 0);
+  REQUIRE(EncodeClassCode("COP350") == 0);
+  REQUIRE(EncodeClassCode("COP35021") == 0);
+  REQUIRE(EncodeClassCode("CO3P502") == 0);
+}
+
+TEST_CASE("Snapshots round-trip the parsed campus", "[snapshot]") {
+  CampusCompass parsed;
+  REQUIRE(parsed.ParseCSV("data/edges.csv", "data/classes.csv"));
+  REQUIRE(parsed.SaveSnapshot("campus.snap"));
+
+  StringSink output;
+  CampusCompass loaded(output);
+  REQUIRE(loaded.LoadSnapshot("campus.snap"));
+  for (int from : {1, 5, 14, 26, 49}) {
+    for (int to : {2, 18, 23, 36, 56}) {
+      REQUIRE(loaded.TravelTime(from, to) == parsed.TravelTime(from, to));
+    }
+  }
+  REQUIRE(loaded.CheckEdgeStatus(45, 47) == "open");
+  REQUIRE(loaded.LocationName(43) == "Malachowsky Hall");
+  REQUIRE(loaded.Insert("Student A", 10000001, 1, {"MAC2311", "COP3502"}));
+  REQUIRE(loaded.PrintShortestEdges(10000001));
+  REQUIRE(output.str() == R"(Name: Student A
+COP3502 | Total Time: 25
+MAC2311 | Total Time: 18
+)");
+
+  SECTION("corrupt snapshots are rejected") {
+    {
+      fstream file("campus.snap", ios::in | ios::out | ios::binary);
+      file.seekp(200);
+      file.put('\x7f');
+    }
+    CampusCompass corrupt;
+    REQUIRE_FALSE(corrupt.LoadSnapshot("campus.snap"));
+    REQUIRE_FALSE(corrupt.LoadSnapshot("data/edges.csv"));
+    REQUIRE_FALSE(corrupt.LoadSnapshot("data/missing.snap"));
+  };
 
-  SECTION("num is 2") {
-    int num = one + 1;
-    REQUIRE(num == 2);
+  SECTION("out of range values are rejected even with a valid checksum") {
+    for (uint32_t target : {(uint32_t)kSectionNeighbors, (uint32_t)kSectionEdgeTable, (uint32_t)kSectionTimes}) {
+      REQUIRE(parsed.SaveSnapshot("campus.snap"));
+      string image;
+      {
+        ifstream file("campus.snap", ios::binary);
+        image.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+      }
+      SnapshotHeader header;
+      memcpy(&header, image.data(), sizeof(header));
+      for (uint64_t i = 0; i < header.section_count; i++) {
+        SnapshotSection section;
+        memcpy(&section, image.data() + sizeof(header) + i * sizeof(section), sizeof(section));
+        if (section.id == target) {
+          int32_t *values = reinterpret_cast<int32_t *>(&image[section.offset]);
+          for (uint64_t j = 0; j < section.count; j++) {
+            // a neighbor past the last location, a table with no empty slot,
+            // a negative travel time
+            values[j] = target == kSectionNeighbors ? 1 << 20 : target == kSectionEdgeTable ? 0 : -5;
+          }
+        }
+      }
+      header.payload_checksum = PayloadHash(image.data() + sizeof(header), header.payload_size);
+      memcpy(&image[0], &header, sizeof(header));
+      {
+        ofstream file("campus.snap", ios::binary | ios::trunc);
+        file.write(image.data(), (streamsize)image.size());
+      }
+      CampusCompass corrupt;
+      REQUIRE_FALSE(corrupt.LoadSnapshot("campus.snap", true));
+    }
   };
 
-  SECTION("num is 3") {
-    int num = one + 2;
-    REQUIRE(num == 3);
+  SECTION("payload damage is only looked for on a verified load") {
+    string image;
+    {
+      ifstream file("campus.snap", ios::binary);
+      image.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    }
+    SnapshotHeader header;
+    memcpy(&header, image.data(), sizeof(header));
+    for (uint64_t i = 0; i < header.section_count; i++) {
+      SnapshotSection section;
+      memcpy(&section, image.data() + sizeof(header) + i * sizeof(section), sizeof(section));
+      if (section.id == kSectionNameChars) {
+        image[section.offset] ^= 0x20;
+      }
+    }
+    {
+      ofstream file("campus.snap", ios::binary | ios::trunc);
+      file.write(image.data(), (streamsize)image.size());
+    }
+    CampusCompass damaged;
+    REQUIRE(damaged.LoadSnapshot("campus.snap"));
+    REQUIRE_FALSE(damaged.LoadSnapshot("campus.snap", true));
   };
 
-  // each section runs the setup code independently to ensure that they don't
-  // affect each other
+  SECTION("saving replaces the file instead of rewriting a mapped one") {
+    REQUIRE(parsed.SaveSnapshot("campus.snap"));
+    REQUIRE_FALSE(ifstream("campus.snap.tmp").good());
+    REQUIRE(loaded.TravelTime(1, 56) == parsed.TravelTime(1, 56));
+    REQUIRE(loaded.LocationName(43) == "Malachowsky Hall");
+  };
+  remove("campus.snap");
+}
+
+TEST_CASE("Inline vectors insert and erase in place", "[students]") {
+  InlineVector<int, 6> values;
+  for (int v : {5, 1, 3}) {
+    values.insert(lower_bound(values.begin(), values.end(), v), v);
+  }
+  values.push_back(9);
+  REQUIRE(vector<int>(values.begin(), values.end()) == vector<int>{1, 3, 5, 9});
+  values.erase(values.begin() + 1);
+  values.erase(values.end() - 1);
+  REQUIRE(vector<int>(values.begin(), values.end()) == vector<int>{1, 5});
+  InlineVector<int, 6> copy = values;
+  copy[0] = 2;
+  REQUIRE(values[0] == 1);
+  REQUIRE(copy.size() == 2);
+}
+
+TEST_CASE("Student table matches a map under churn", "[students]") {
+  StudentTable table;
+  unordered_map<int, int> expected; // ufid -> residence, also the name's length
+  mt19937 rng(2024);
+  // a narrow UFID range keeps probe runs long and removals frequent
+  uniform_int_distribution<int> ufids(10000000, 10003000);
+  bool consistent = true;
+  for (int step = 0; step < 40000; step++) {
+    int ufid = ufids(rng);
+    if (rng() % 3 == 0) {
+      consistent &= table.Erase(ufid) == (expected.erase(ufid) > 0);
+    } else {
+      bool fresh = !expected.count(ufid);
+      int slot = table.Insert(ufid, step, string(step % 40, 'a' + ufid % 26));
+      consistent &= (slot >= 0) == fresh;
+      if (fresh) {
+        expected[ufid] = step;
+      }
+    }
+  }
+  REQUIRE(consistent);
+  REQUIRE(table.size() == (int)expected.size());
+  for (int ufid = 10000000; ufid <= 10003000; ufid++) {
+    auto it = expected.find(ufid);
+    const Student *student = table.Get(ufid);
+    consistent &= (student != nullptr) == (it != expected.end());
+    consistent &= !student || (student->ufid == ufid && student->residence_id == it->second &&
+                               table.Name(*student) == string(it->second % 40, 'a' + ufid % 26));
+  }
+  REQUIRE(consistent);
+  int used = 0;
+  for (int slot = 0; slot < table.SlotCount(); slot++) {
+    used += table.IsUsed(slot);
+  }
+  REQUIRE(used == table.size());
+}
+
+TEST_CASE("Student registry commands", "[students]") {
+  CampusCompass c;
+  REQUIRE(c.ParseCSV("data/edges.csv", "data/classes.csv"));
+
+  REQUIRE(c.Insert("Student A", 10000001, 1, {"COP3502", "MAC2311"}));
+  REQUIRE_FALSE(c.Insert("Student B", 10000001, 1, {"COP3502"}));            // duplicate UFID
+  REQUIRE_FALSE(c.Insert("Student B", 10000002, 1, {"COP9999"}));            // unknown class
+  REQUIRE_FALSE(c.Insert("Student B", 10000002, 1, {"COP3502", "COP3502"})); // repeated class
+  REQUIRE_FALSE(c.Insert("Student B", 10000002, 1, {}));
+
+  REQUIRE(c.ReplaceClass(10000001, "MAC2311", "COP3503"));
+  REQUIRE_FALSE(c.ReplaceClass(10000001, "MAC2311", "COP3504")); // not enrolled
+  REQUIRE_FALSE(c.ReplaceClass(10000001, "COP3502", "COP3503")); // already enrolled
+  REQUIRE_FALSE(c.DropClass(10000001, "MAC2311"));
+  REQUIRE(c.DropClass(10000001, "COP3503"));
+  REQUIRE(c.RemoveClass("COP3502") == 1); // drops student A entirely
+  REQUIRE_FALSE(c.Remove(10000001));
+  REQUIRE(c.RemoveClass("COP3502") == 0);
+  REQUIRE(c.RemoveClass("COP9999") == -1);
+}
+
+TEST_CASE("Classes missing from a reloaded catalog are skipped", "[students]") {
+  StringSink output;
+  CampusCompass c(output);
+  REQUIRE(c.ParseCSV("data/edges.csv", "data/classes.csv"));
+  REQUIRE(c.Insert("Student A", 10000001, 1, {"COP3502", "MAC2311", "COP3503"}));
+  {
+    ifstream full("data/classes.csv");
+    ofstream smaller("smaller_classes.csv");
+    string line;
+    while (getline(full, line)) {
+      if (line.rfind("MAC2311", 0) != 0) {
+        smaller << line << '\n';
+      }
+    }
+  }
+  bool parsed = c.ParseCSV("data/edges.csv", "smaller_classes.csv");
+  remove("smaller_classes.csv");
+  REQUIRE(parsed);
+
+  REQUIRE(c.PrintShortestEdges(10000001));
+  REQUIRE(output.str().find("MAC2311 | Total Time: -1\n") != string::npos);
+  REQUIRE(c.StudentZoneCost(10000001) >= 0);
+  output.clear();
+  REQUIRE(c.VerifySchedule(10000001));
+  REQUIRE(output.str().find("MAC2311") == string::npos);
+  REQUIRE(output.str().find("COP3502 - COP3503 \"Can make it!\"") != string::npos);
+  REQUIRE(c.UnmakeableScheduleCount() == 0);
+  REQUIRE(c.DropClass(10000001, "COP3502"));
+  REQUIRE(c.Remove(10000001));
+}
+
+TEST_CASE("Class rosters follow every registry change", "[students]") {
+  CampusCompass c;
+  REQUIRE(c.ParseCSV("data/edges.csv", "data/classes.csv"));
+  vector<string> codes = CatalogCodes("data/classes.csv");
+
+  map<int, set<string>> expected; // ufid -> classes
+  mt19937 rng(7);
+  bool consistent = true;
+  for (int step = 0; step < 20000; step++) {
+    int ufid = 10000000 + (int)(rng() % 300);
+    const string &code = codes[rng() % codes.size()];
+    const string &other = codes[rng() % codes.size()];
+    auto it = expected.find(ufid);
+    switch (rng() % 5) {
+    case 0: {
+      set<string> picked = {code, other};
+      vector<string_view> views(picked.begin(), picked.end());
+      bool ok = it == expected.end();
+      consistent &= c.Insert("S", ufid, 1, views) == ok;
+      if (ok) {
+        expected[ufid] = picked;
+      }
+      break;
+    }
+    case 1:
+      consistent &= c.Remove(ufid) == (expected.erase(ufid) > 0);
+      break;
+    case 2: {
+      bool ok = it != expected.end() && it->second.erase(code) > 0;
+      consistent &= c.DropClass(ufid, code) == ok;
+      if (ok && it->second.empty()) {
+        expected.erase(it);
+      }
+      break;
+    }
+    case 3: {
+      bool ok = it != expected.end() && it->second.count(code) && !it->second.count(other);
+      consistent &= c.ReplaceClass(ufid, code, other) == ok;
+      if (ok) {
+        it->second.erase(code);
+        it->second.insert(other);
+      }
+      break;
+    }
+    default:
+      if (rng() % 10 == 0) {
+        int enrolled = 0;
+        for (auto student = expected.begin(); student != expected.end();) {
+          enrolled += (int)student->second.erase(code);
+          student = student->second.empty() ? expected.erase(student) : next(student);
+        }
+        consistent &= c.RemoveClass(code) == enrolled;
+      }
+    }
+  }
+  REQUIRE(consistent);
+  REQUIRE(c.ParseCSV("data/edges.csv", "data/classes.csv")); // rosters are rebuilt
+  for (const string &code : codes) {
+    int enrolled = 0;
+    for (const auto &[ufid, taken] : expected) {
+      enrolled += (int)taken.count(code);
+    }
+    REQUIRE(c.RemoveClass(code) == enrolled);
+  }
+}
+
+TEST_CASE("Registry reports match per-student commands", "[students]") {
+  StringSink output;
+  CampusCompass c(output);
+  REQUIRE(c.ParseCSV("data/edges.csv", "data/classes.csv"));
+  vector<string> codes = CatalogCodes("data/classes.csv");
+
+  mt19937 rng(11);
+  map<int, int> residents;
+  for (int ufid = 10000000; ufid < 10000200; ufid++) {
+    set<string> picked;
+    for (int i = 0, n = 1 + (int)(rng() % 4); i < n; i++) {
+      picked.insert(codes[rng() % codes.size()]);
+    }
+    int residence = 1 + (int)(rng() % 8);
+    REQUIRE(c.Insert("S", ufid, residence, vector<string_view>(picked.begin(), picked.end())));
+    residents[residence]++;
+  }
+  // residences off the map sort in on either side
+  REQUIRE(c.Insert("Off Campus", 10000200, 999, {"COP3502"}));
+  REQUIRE(c.Insert("Off Campus", 10000201, 0, {"COP3502"}));
+  residents[999]++;
+  residents[0]++;
+  REQUIRE(c.Columns().size() == 202);
+
+  // the columns follow every change in place; a removed student's row is freed
+  int dropped = c.Columns().ufids[1];
+  int classes_before = c.Columns().class_counts[1];
+  if (classes_before > 1) {
+    REQUIRE(c.DropClass(dropped, DecodeClassCode(c.Columns().ClassesOf(1)[0])));
+    REQUIRE(c.Columns().class_counts[1] == classes_before - 1);
+  }
+  residents[c.Columns().residence_ids[0]]--;
+  REQUIRE(c.Remove(c.Columns().ufids[0]));
+  REQUIRE(c.Columns().ufids[0] == -1);
+  REQUIRE(c.Columns().class_counts[0] == 0);
+
+  int unmakeable = 0;
+  for (int row = 0; row < c.Columns().size(); row++) {
+    output.clear();
+    c.VerifySchedule(c.Columns().ufids[row]); // false for the free row
+    unmakeable += output.str().find("Cannot") != string::npos;
+  }
+  REQUIRE(c.UnmakeableScheduleCount() == unmakeable);
+
+  vector<pair<int, int>> expected_histogram;
+  for (auto [residence, count] : residents) {
+    if (count > 0) {
+      expected_histogram.emplace_back(residence, count);
+    }
+  }
+  REQUIRE(c.ResidenceHistogram() == expected_histogram);
+
+  for (auto [key, count] : c.EnrollmentByClass()) {
+    int expected = 0;
+    for (int row = 0; row < c.Columns().size(); row++) {
+      const ClassKey *keys = c.Columns().ClassesOf(row);
+      expected += (int)count_if(keys, keys + c.Columns().class_counts[row], [key = key](ClassKey k) { return k == key; });
+    }
+    REQUIRE(count == expected);
+  }
+  int before = c.EnrollmentByClass()[0].second;
+  REQUIRE(c.RemoveClass(c.EnrollmentByClass()[0].first) == before);
+}
+
+TEST_CASE("Command validation", "[commands]") {
+  StringSink output;
+  CampusCompass c(output);
+  REQUIRE(c.ParseCSV("data/edges.csv", "data/classes.csv"));
+
+  REQUIRE(c.ParseCommand(R"(insert "Student A" 10000001 1 1 COP3502)"));
+  REQUIRE_FALSE(c.ParseCommand(R"(insert "Student 1" 10000002 1 1 COP3502)"));  // digits in name
+  REQUIRE_FALSE(c.ParseCommand(R"(insert "Student B" 1000002 1 1 COP3502)"));   // 7 digit UFID
+  REQUIRE_FALSE(c.ParseCommand(R"(insert "Student B" 10000002 1 2 COP3502)"));  // wrong count
+  REQUIRE_FALSE(c.ParseCommand(R"(insert "Student B" 10000002 1 1 cop3502)"));  // lowercase code
+  REQUIRE_FALSE(c.ParseCommand(R"(insert "Student B" 10000002 1 1 COP3502 )")); // trailing space
+  REQUIRE_FALSE(c.ParseCommand(R"(insert Student B 10000002 1 1 COP3502)"));    // unquoted name
+  REQUIRE_FALSE(c.ParseCommand("launch 10000001"));
+  REQUIRE_FALSE(c.ParseCommand("remove  10000001"));
+  REQUIRE_FALSE(c.ParseCommand("toggleEdgesClosure 2 1 2"));
+  REQUIRE(c.ParseCommand("toggleEdgesClosure 1 1 2"));
+  REQUIRE(c.ParseCommand("checkEdgeStatus 1 2"));
+  REQUIRE(c.ParseCommand("isConnected 1 2"));
+  REQUIRE_FALSE(c.ParseCommand("isConnected 1 36"));
+  REQUIRE(c.ParseCommand("remove 10000001\r"));
+  REQUIRE_FALSE(c.ParseCommand(R"(insert "Student G" 10000007 1 7 COP3502 COP3503 COP3504 COT3100 COP3530 CDA3101 MAC2311)"));
+  REQUIRE_FALSE(c.ParseCommand("toggleEdgesClosure 0"));
+  REQUIRE_FALSE(c.ParseCommand("checkEdgeStatus 1234567890 1"));
+  REQUIRE_FALSE(c.ParseCommand("removeClass COP35021"));
+
+  REQUIRE(output.str() == R"(successful
+unsuccessful
+unsuccessful
+unsuccessful
+unsuccessful
+unsuccessful
+unsuccessful
+unsuccessful
+unsuccessful
+unsuccessful
+successful
+closed
+successful
+unsuccessful
+successful
+unsuccessful
+unsuccessful
+unsuccessful
+unsuccessful
+)");
+}
+
+TEST_CASE("ProcessBatch runs a whole command stream", "[commands]") {
+  CampusCompass c;
+  REQUIRE(c.ParseCSV("data/edges.csv", "data/classes.csv"));
+  StringSink output;
+  // CRLF line endings, and fewer commands than announced
+  REQUIRE(c.ProcessBatch("3\r\nremove 10000001\r\nremoveClass COP3502\r\n", output));
+  REQUIRE(output.str() == "unsuccessful\n0\n");
+
+  output.clear();
+  REQUIRE(c.ProcessBatch("1\ncheckEdgeStatus 1 2\ncheckEdgeStatus 1 3\n", output));
+  REQUIRE(output.str() == "open\n");
+  REQUIRE_FALSE(c.ProcessBatch("checkEdgeStatus 1 2\n", output));
+}
+
+TEST_CASE("ProcessStream stops after the announced commands", "[commands]") {
+  CampusCompass c;
+  REQUIRE(c.ParseCSV("data/edges.csv", "data/classes.csv"));
+  int ends[2];
+  REQUIRE(pipe(ends) == 0);
+  // the write end stays open, as with a producer that waits for the output
+  string input = "2\ncheckEdgeStatus 1 2\ncheckEdgeStatus 1 3";
+  REQUIRE(write(ends[1], input.data(), input.size()) == (ssize_t)input.size());
+  REQUIRE(write(ends[1], "\nnever read\n", 12) == 12);
+  LineReader lines(ends[0]);
+  StringSink output;
+  REQUIRE(c.ProcessStream(lines, output));
+  REQUIRE(output.str() == "open\nDNE\n");
+  string_view rest;
+  REQUIRE(lines.Next(rest));
+  REQUIRE(rest == "never read");
+
+  // the last line may lack its newline once the writer is done
+  REQUIRE(write(ends[1], "tail", 4) == 4);
+  close(ends[1]);
+  REQUIRE(lines.Next(rest));
+  REQUIRE(rest == "tail");
+  REQUIRE_FALSE(lines.Next(rest));
+  close(ends[0]);
+}
+
+TEST_CASE("FdSink writes buffered output on flush", "[io]") {
+  FILE *file = tmpfile();
+  REQUIRE(file != nullptr);
+  {
+    FdSink sink(fileno(file));
+    sink << "successful" << '\n' << 42 << '\n';
+    REQUIRE(ftell(file) == 0); // still buffered
+  }
+  rewind(file);
+  char contents[32] = {};
+  REQUIRE(fread(contents, 1, sizeof(contents) - 1, file) == 14);
+  REQUIRE(string(contents) == "successful\n42\n");
+  fclose(file);
+}
+
+TEST_CASE("Bucket and heap queues give the same shortest paths", "[paths]") {
+  CampusGraph graph = RandomGraph(12345, 120, 400);
+  // parallel edges resolve to the first one in file order
+  bool lookups_ok = true;
+  for (int e = 0; e < graph.EdgeCount(); e++) {
+    int x = graph.LocationId(graph.EdgeSource(e));
+    int y = graph.LocationId(graph.EdgeTarget(e));
+    int found = graph.FindEdge(y, x);
+    lookups_ok &= found >= 0 && found <= e && graph.FindEdge(x, y) == found;
+  }
+  REQUIRE(lookups_ok);
+  auto all_open = [](int) { return true; };
+  auto even_open = [](int edge) { return edge % 2 == 0; };
+
+  ShortestPathTree bucket, heap;
+  for (int source = 0; source < graph.LocationCount(); source++) {
+    Dijkstra<BucketQueue>(graph, source, -1, all_open, bucket);
+    Dijkstra<BinaryHeapQueue>(graph, source, -1, all_open, heap);
+    REQUIRE(bucket.dist == heap.dist);
+    for (int v = 0; v < graph.LocationCount(); v++) {
+      if (bucket.parents[v] != -1) {
+        REQUIRE(bucket.dist[v] >= bucket.dist[bucket.parents[v]]);
+      }
+    }
+    Dijkstra<BucketQueue>(graph, source, -1, even_open, bucket);
+    Dijkstra<BinaryHeapQueue>(graph, source, -1, even_open, heap);
+    REQUIRE(bucket.dist == heap.dist);
+  }
+
+  // stopping at a target still gives its final distance
+  Dijkstra<BinaryHeapQueue>(graph, 0, -1, all_open, heap);
+  for (int target = 0; target < graph.LocationCount(); target++) {
+    Dijkstra<BucketQueue>(graph, 0, target, all_open, bucket);
+    REQUIRE(bucket.dist[target] == heap.dist[target]);
+  }
+}
+
+TEST_CASE("Repaired trees match a full recompute", "[paths]") {
+  CampusGraph graph = RandomGraph(777, 80, 200);
+  vector<bool> closed(graph.EdgeCount(), false);
+  auto is_open = [&closed](int edge) { return !closed[edge]; };
+  vector<ShortestPathTree> trees(graph.LocationCount());
+  for (int source = 0; source < graph.LocationCount(); source++) {
+    Dijkstra<BucketQueue>(graph, source, -1, is_open, trees[source]);
+  }
+
+  unsigned seed = 99;
+  for (int round = 0; round < 40; round++) {
+    // toggle a handful of edges at a time, closures before openings
+    vector<int> closing, opening;
+    for (int i = 0; i < 5; i++) {
+      seed = seed * 1103515245 + 12345;
+      int edge = (int)((seed >> 8) % graph.EdgeCount());
+      if (find(closing.begin(), closing.end(), edge) == closing.end() &&
+          find(opening.begin(), opening.end(), edge) == opening.end()) {
+        (closed[edge] ? opening : closing).push_back(edge);
+      }
+    }
+    for (int edge : closing) {
+      closed[edge] = true;
+    }
+    for (ShortestPathTree &tree : trees) {
+      RepairAfterClosures(graph, tree, closing, is_open);
+    }
+    for (int edge : opening) {
+      closed[edge] = false;
+    }
+    for (ShortestPathTree &tree : trees) {
+      RepairAfterOpenings(graph, tree, opening, is_open);
+    }
+
+    ShortestPathTree expected;
+    for (int source = 0; source < graph.LocationCount(); source++) {
+      Dijkstra<BinaryHeapQueue>(graph, source, -1, is_open, expected);
+      const ShortestPathTree &tree = trees[source];
+      REQUIRE(tree.dist == expected.dist);
+      // every parent edge is open, joins the pair and does not go backwards
+      bool consistent = true;
+      for (int v = 0; v < graph.LocationCount(); v++) {
+        int edge = tree.parent_edges[v];
+        int u = tree.parents[v];
+        if (edge == -1) {
+          consistent &= u == -1 && (v == source || tree.dist[v] == kUnreachable);
+        } else {
+          consistent &= !closed[edge] && tree.dist[u] <= tree.dist[v] &&
+                        ((graph.EdgeSource(edge) == u && graph.EdgeTarget(edge) == v) ||
+                         (graph.EdgeSource(edge) == v && graph.EdgeTarget(edge) == u));
+        }
+      }
+      REQUIRE(consistent);
+    }
+  }
+}
+
+TEST_CASE("Bidirectional search matches unidirectional Dijkstra", "[paths]") {
+  CampusGraph graph = RandomGraph(4242, 150, 300);
+  auto even_open = [](int edge) { return edge % 2 == 0; };
+  ShortestPathTree tree;
+  bool same = true;
+  for (int source = 0; source < graph.LocationCount(); source++) {
+    Dijkstra<BinaryHeapQueue>(graph, source, -1, even_open, tree);
+    for (int target = 0; target < graph.LocationCount(); target++) {
+      same &= BidirectionalDijkstra<BucketQueue>(graph, source, target, even_open) == tree.dist[target];
+      same &= BidirectionalDijkstra<BinaryHeapQueue>(graph, source, target, even_open) == tree.dist[target];
+    }
+  }
+  REQUIRE(same);
+
+  // on a 100x100 grid, corner to centre settles far fewer locations
+  CampusGraph grid = GridGraph(100, 3);
+  auto all_open = [](int) { return true; };
+  Dijkstra<BucketQueue>(grid, 0, 5050, all_open, tree);
+  int unidirectional = (int)count_if(tree.dist.begin(), tree.dist.end(), [](int d) { return d != kUnreachable; });
+  int bidirectional;
+  REQUIRE(BidirectionalDijkstra<BucketQueue>(grid, 0, 5050, all_open, &bidirectional) == tree.dist[5050]);
+  REQUIRE(bidirectional < unidirectional);
+
+  StringSink output;
+  CampusCompass c(output);
+  REQUIRE(c.ParseCSV("data/edges.csv", "data/classes.csv"));
+  REQUIRE(c.ToggleEdgesClosure({{1, 4}}));
+  for (int from : {1, 5, 14, 26, 49}) {
+    for (int to : {2, 4, 18, 23, 36, 56}) {
+      c.SetPathEngine(PathEngine::SourceTree);
+      int expected = c.TravelTime(from, to);
+      c.SetPathEngine(PathEngine::Bidirectional);
+      REQUIRE(c.TravelTime(from, to) == expected);
+    }
+  }
+}
+
+TEST_CASE("Contraction hierarchy queries match Dijkstra", "[paths]") {
+  CampusGraph graph = RandomGraph(2024, 150, 320);
+  Bitset closed;
+  closed.Reset(graph.EdgeCount());
+  for (int e = 0; e < graph.EdgeCount(); e += 7) {
+    closed.Flip(e);
+  }
+  ContractionHierarchy hierarchy;
+  hierarchy.Build(graph, closed);
+  REQUIRE_FALSE(hierarchy.Empty());
+
+  auto is_open = [&closed](int edge) { return !closed.Test(edge); };
+  ShortestPathTree tree;
+  bool same = true;
+  for (int source = 0; source < graph.LocationCount(); source++) {
+    Dijkstra<BinaryHeapQueue>(graph, source, -1, is_open, tree);
+    for (int target = 0; target < graph.LocationCount(); target++) {
+      same &= hierarchy.Query(source, target) == tree.dist[target];
+    }
+  }
+  REQUIRE(same);
+
+  // closures fall back to plain search until the hierarchy is rebuilt
+  StringSink output;
+  CampusCompass c(output);
+  REQUIRE(c.ParseCSV("data/edges.csv", "data/classes.csv"));
+  c.SetPathEngine(PathEngine::Hierarchy);
+  REQUIRE(c.TravelTime(1, 5) == 8);
+  c.BuildHierarchy();
+  REQUIRE(c.TravelTime(1, 5) == 8);
+  REQUIRE(c.TravelTime(5, 56) == 12);
+  REQUIRE(c.TravelTime(1, 26) == -1);
+  REQUIRE(c.ToggleEdgesClosure({{1, 4}}));
+  REQUIRE(c.TravelTime(1, 4) == 6);
+  c.BuildHierarchy();
+  REQUIRE(c.TravelTime(1, 4) == 6);
+  REQUIRE(c.ToggleEdgesClosure({{1, 4}}));
+  REQUIRE(c.TravelTime(1, 4) == 2);
+}
+
+TEST_CASE("Landmark A* matches Dijkstra", "[paths]") {
+  CampusGraph graph = RandomGraph(31337, 150, 260); // several components
+  Bitset closed;
+  closed.Reset(graph.EdgeCount());
+  for (int e = 0; e < graph.EdgeCount(); e += 5) {
+    closed.Flip(e);
+  }
+  auto is_open = [&closed](int edge) { return !closed.Test(edge); };
+  for (int count : {0, 1, 4, 16}) {
+    LandmarkIndex landmarks;
+    landmarks.Build(graph, count);
+    REQUIRE(landmarks.LandmarkCount() == count);
+    ShortestPathTree tree;
+    bool same = true;
+    for (int source = 0; source < graph.LocationCount(); source++) {
+      Dijkstra<BinaryHeapQueue>(graph, source, -1, is_open, tree);
+      for (int target = 0; target < graph.LocationCount(); target++) {
+        same &= landmarks.Query(graph, closed, source, target) == tree.dist[target];
+      }
+    }
+    REQUIRE(same);
+  }
+
+  // landmarks cut the search down on a grid
+  CampusGraph grid = GridGraph(60, 4);
+  Bitset none;
+  none.Reset(grid.EdgeCount());
+  LandmarkIndex plain, alt;
+  alt.Build(grid, 8);
+  int plain_settled, alt_settled;
+  REQUIRE(plain.Query(grid, none, 0, 1830, &plain_settled) == alt.Query(grid, none, 0, 1830, &alt_settled));
+  REQUIRE(alt_settled < plain_settled);
+
+  StringSink output;
+  CampusCompass c(output, 4);
+  REQUIRE(c.ParseCSV("data/edges.csv", "data/classes.csv"));
+  c.SetPathEngine(PathEngine::Landmarks);
+  REQUIRE(c.TravelTime(1, 5) == 8);
+  REQUIRE(c.TravelTime(1, 26) == -1);
+  REQUIRE(c.ToggleEdgesClosure({{1, 4}}));
+  REQUIRE(c.TravelTime(1, 4) == 6);
+  REQUIRE(c.Statistics().queries == 3);
+  REQUIRE(c.Statistics().settled > 0);
+  c.ResetStatistics();
+  REQUIRE(c.Statistics().queries == 0);
+}
+
+TEST_CASE("Automatic engine takes the matrix only on small maps", "[paths]") {
+  CampusCompass c;
+  for (int locations : {256, 257}) {
+    {
+      ofstream edges("path_edges.csv");
+      edges << "LocationID_1,LocationID_2,Name_1,Name_2,Time\n";
+      for (int i = 1; i < locations; i++) {
+        edges << i << "," << i + 1 << ",A,B,1\n";
+      }
+    }
+    bool parsed = c.ParseCSV("path_edges.csv", "data/classes.csv");
+    remove("path_edges.csv");
+    REQUIRE(parsed);
+    REQUIRE(c.ActiveEngine() == PathEngine::SourceTree); // the default
+    c.SetPathEngine(PathEngine::Automatic);
+    REQUIRE(c.ActiveEngine() == (locations <= 256 ? PathEngine::Matrix : PathEngine::SourceTree));
+    REQUIRE(c.TravelTime(1, locations) == locations - 1);
+    c.SetPathEngine(PathEngine::SourceTree);
+  }
+}
+
+TEST_CASE("All-pairs matrix matches Dijkstra", "[paths]") {
+  string kernel = DistanceMatrix::KernelName();
+  REQUIRE((kernel == "avx2" || kernel == "sse2" || kernel == "scalar"));
+
+  // 150 locations span three tiles; long edges force int32 cells
+  for (int scale : {1, 1000}) {
+    CampusGraph graph = RandomGraph(5150, 150, 300, scale);
+    Bitset closed;
+    closed.Reset(graph.EdgeCount());
+    for (int e = 0; e < graph.EdgeCount(); e += 6) {
+      closed.Flip(e);
+    }
+    DistanceMatrix matrix;
+    REQUIRE(matrix.Build(graph, closed));
+    REQUIRE(matrix.IsNarrow() == (scale == 1));
+    REQUIRE(DistanceMatrix::BytesNeeded(graph) == 192 * 192 * (scale == 1 ? 2 : 4));
+
+    auto is_open = [&closed](int edge) { return !closed.Test(edge); };
+    ShortestPathTree tree;
+    bool same = true;
+    for (int source = 0; source < graph.LocationCount(); source++) {
+      Dijkstra<BinaryHeapQueue>(graph, source, -1, is_open, tree);
+      for (int target = 0; target < graph.LocationCount(); target++) {
+        same &= matrix.At(source, target) == tree.dist[target];
+      }
+    }
+    REQUIRE(same);
+  }
+
+  StringSink output;
+  CampusCompass c(output);
+  REQUIRE(c.ParseCSV("data/edges.csv", "data/classes.csv"));
+  c.SetPathEngine(PathEngine::Matrix);
+  REQUIRE(c.TravelTime(1, 4) == 2);
+  REQUIRE(c.TravelTime(1, 26) == -1);
+  REQUIRE(c.ToggleEdgesClosure({{1, 4}}));
+  REQUIRE(c.TravelTime(1, 4) == 6);
+  REQUIRE(c.Insert("Student A", 10000001, 1, {"MAC2311", "COP3502"}));
+  REQUIRE(c.ToggleEdgesClosure({{1, 4}}));
+  REQUIRE(c.PrintShortestEdges(10000001));
+  REQUIRE(output.str() == R"(Name: Student A
+COP3502 | Total Time: 25
+MAC2311 | Total Time: 18
+)");
+}
+
+TEST_CASE("Work-stealing pool runs nested tasks", "[threads]") {
+  ThreadPool pool(4);
+  atomic<int> sum{0};
+  // one outside task fans out; idle workers have to steal to help
+  pool.Submit([&] {
+    for (int i = 1; i <= 1000; i++) {
+      pool.Submit([&sum, i] { sum += i; });
+    }
+  });
+  pool.Wait();
+  REQUIRE(sum == 500500);
+  for (int i = 0; i < 100; i++) {
+    pool.Submit([&sum] { sum--; });
+  }
+  pool.Wait();
+  REQUIRE(sum == 500400);
+}
+
+TEST_CASE("Parallel rebuilds match sequential ones", "[threads]") {
+  CampusGraph graph = RandomGraph(8080, 150, 300);
+  Bitset closed;
+  closed.Reset(graph.EdgeCount());
+  for (int e = 0; e < graph.EdgeCount(); e += 4) {
+    closed.Flip(e);
+  }
+  ThreadPool pool(3);
+  DistanceMatrix floyd, searched;
+  REQUIRE(floyd.Build(graph, closed));
+  REQUIRE(searched.Build(graph, closed, &pool));
+  bool same = true;
+  for (int u = 0; u < graph.LocationCount(); u++) {
+    for (int v = 0; v < graph.LocationCount(); v++) {
+      same &= floyd.At(u, v) == searched.At(u, v);
+    }
+  }
+  REQUIRE(same);
+
+  // several cached trees are repaired on the pool
+  StringSink output;
+  CampusCompass c(output);
+  REQUIRE(c.ParseCSV("data/edges.csv", "data/classes.csv"));
+  c.SetPathEngine(PathEngine::SourceTree);
+  for (int from : {1, 5, 14, 26, 49}) {
+    c.TravelTime(from, 2);
+  }
+  REQUIRE(c.ToggleEdgesClosure({{1, 4}, {52, 33}, {45, 47}}));
+  for (int from : {1, 5, 14, 26, 49}) {
+    for (int to : {2, 4, 18, 23, 33, 36, 56}) {
+      c.SetPathEngine(PathEngine::SourceTree);
+      int cached = c.TravelTime(from, to);
+      c.SetPathEngine(PathEngine::Matrix);
+      REQUIRE(c.TravelTime(from, to) == cached);
+    }
+  }
+  // the matrix is rebuilt on the pool after this toggle
+  REQUIRE(c.ToggleEdgesClosure({{1, 4}}));
+  REQUIRE(c.TravelTime(1, 4) == 2);
+}
+
+TEST_CASE("Travel reports", "[paths]") {
+  StringSink output;
+  CampusCompass c(output);
+  REQUIRE(c.ParseCSV("data/edges.csv", "data/classes.csv"));
+  REQUIRE(c.Insert("Student A", 10000001, 1, {"MAC2311", "COP3502", "COT3100"}));
+  REQUIRE(c.Insert("Student B", 10000002, 26, {"COP3502"}));
+
+  SECTION("printShortestEdges") {
+    REQUIRE(c.PrintShortestEdges(10000001));
+    REQUIRE(c.PrintShortestEdges(10000002));
+    REQUIRE_FALSE(c.PrintShortestEdges(10000003));
+    REQUIRE(output.str() == R"(Name: Student A
+COP3502 | Total Time: 25
+COT3100 | Total Time: 25
+MAC2311 | Total Time: 18
+Name: Student B
+COP3502 | Total Time: -1
+)");
+  };
+
+  SECTION("printStudentZone") {
+    // the zone is {1, 3, 4, 6, 13, 15, 18, 23}: the union of the paths to locations 18 and 23
+    REQUIRE(c.StudentZoneCost(10000002) == 0);
+    REQUIRE(c.StudentZoneCost(10000003) == -1);
+    REQUIRE(c.PrintStudentZone(10000001));
+    REQUIRE(output.str() == "Student Zone Cost For Student A: 27\n");
+  };
+
+  SECTION("verifySchedule") {
+    REQUIRE_FALSE(c.VerifySchedule(10000002)); // only one class
+    REQUIRE(c.VerifySchedule(10000001));
+    REQUIRE(output.str() == R"(Schedule Check for Student A:
+COT3100 - COP3502 "Can make it!"
+COP3502 - MAC2311 "Cannot make it!"
+)");
+  };
+
+  SECTION("cached trees follow closures") {
+    c.SetPathEngine(PathEngine::SourceTree);
+    REQUIRE(c.TravelTime(1, 4) == 2);
+    REQUIRE(c.TravelTime(1, 4) == 2);
+    REQUIRE(c.ToggleEdgesClosure({{1, 4}}));
+    REQUIRE(c.TravelTime(1, 4) == 6);
+    REQUIRE_FALSE(c.ToggleEdgesClosure({{1, 999}}));
+    REQUIRE(c.TravelTime(1, 4) == 6);
+    REQUIRE(c.ToggleEdgesClosure({{4, 1}}));
+    REQUIRE(c.TravelTime(1, 4) == 2);
+  };
 }
 
 // Refer to Canvas for a list of required tests. 
@@ -69,16 +1126,11 @@ unsuccessful
 2
 )";
 
-  string actualOutput;
-
-  // somehow pass your input into your CampusCompass and parse it to call the
-  // correct functions, for example:
-  /*
   CampusCompass c;
-  c.parseInput(input)
-  // this would be some function that sends the output from your class into a string for use in testing
-  actualOutput = c.getStringRepresentation()
-  */
+  REQUIRE(c.ParseCSV("data/edges.csv", "data/classes.csv"));
+  StringSink output;
+  REQUIRE(c.ProcessBatch(input, output));
 
+  string actualOutput = output.str();
   REQUIRE(actualOutput == expectedOutput);
 }